@@ -0,0 +1,150 @@
+#ifndef ENGINE_CORE_ARENA_H
+#define ENGINE_CORE_ARENA_H
+
+#include <engine/core/types.h>
+
+namespace xc {
+    struct arena_marker {
+        void* chunk;
+        size_t offset;
+    };
+
+    // Bump pointer allocator over a chain of malloc'd chunks.  Individual allocations are never freed; memory is
+    // released all at once with reset() or back to a marker with rewind().  No destructor, call release() manually
+    class linear_arena {
+    public:
+        constexpr linear_arena() = default;
+        constexpr explicit linear_arena(size_t chunk_size) : _chunk_size{chunk_size} {}
+
+        auto allocate(size_t size, size_t alignment = alignof(std::max_align_t)) -> void* {
+            auto address = align(_offset, alignment);
+            if (!_chunk || address + size > _chunk->capacity) {
+                if (!grow(size + alignment)) return nullptr;
+                address = align(0, alignment);
+            }
+
+            _offset = address + size;
+            return data() + address;
+        }
+
+        [[nodiscard]] auto marker() const -> arena_marker { return {_chunk, _offset}; }
+
+        auto rewind(arena_marker const& marker) -> void {
+            while (_chunk && _chunk != marker.chunk) {
+                auto const previous = _chunk->previous;
+                xc::deallocate(_chunk, memory_tag::core);
+                _chunk = previous;
+            }
+            _offset = marker.offset;
+        }
+
+        // Frees everything.  If the arena spilled into more than one chunk, the next chunk is sized to hold it all
+        auto reset() -> void {
+            if (_chunk && _chunk->previous) {
+                auto total = size_t{};
+                for (auto c = _chunk; c; c = c->previous) total += c->capacity;
+                release();
+                _chunk_size = total;
+            }
+            _offset = 0;
+        }
+
+        auto release() -> void { rewind({}); }
+
+        [[nodiscard]] auto used() const -> size_t { return _offset; }
+
+    private:
+        struct chunk {
+            chunk* previous;
+            size_t capacity;
+        };
+
+        chunk* _chunk = nullptr;
+        size_t _offset = 0u;
+        size_t _chunk_size = size_t{64} << 10;
+
+        auto data() const -> char* { return reinterpret_cast<char*>(_chunk + 1); }
+
+        // Aligns an offset so the resulting address, not the offset itself, is aligned
+        auto align(size_t offset, size_t alignment) const -> size_t {
+            if (!_chunk) return offset;
+            auto const address = reinterpret_cast<uintptr_t>(data()) + offset;
+            return offset + (((address + alignment - 1) & ~(alignment - 1)) - address);
+        }
+
+        auto grow(size_t min_capacity) -> bool {
+            auto const capacity = min_capacity > _chunk_size ? min_capacity : _chunk_size;
+            auto const c = static_cast<chunk*>(xc::allocate(sizeof(chunk) + capacity, memory_tag::core));
+            if (!c) return false;
+
+            c->previous = _chunk;
+            c->capacity = capacity;
+            _chunk = c;
+            _offset = 0;
+            return true;
+        }
+    };
+
+    // Two linear arenas used on alternate frames, so data written during frame N stays valid through frame N + 1
+    class frame_arena {
+    public:
+        constexpr frame_arena() = default;
+
+        auto begin_frame() -> void {
+            _index ^= 1u;
+            _arenas[_index].reset();
+        }
+
+        auto current() -> linear_arena& { return _arenas[_index]; }
+        auto previous() -> linear_arena& { return _arenas[_index ^ 1u]; }
+
+        auto release() -> void {
+            _arenas[0].release();
+            _arenas[1].release();
+        }
+
+    private:
+        linear_arena _arenas[2];
+        uint32_t _index = 0u;
+    };
+
+    // Rewinds an arena to where it was when the scope was entered
+    class arena_scope {
+    public:
+        explicit arena_scope(linear_arena& arena) : _arena{arena}, _marker{arena.marker()} {}
+        ~arena_scope() { _arena.rewind(_marker); }
+
+        arena_scope(arena_scope const&) = delete;
+        auto operator=(arena_scope const&) -> arena_scope& = delete;
+
+    private:
+        linear_arena& _arena;
+        arena_marker _marker;
+    };
+
+    // Scratch memory for the main thread's frame, flipped by the begin_frame() call at the top of each one.  Not
+    // synchronized: only that thread may allocate from it, directly or through frame_allocator.  The render thread and
+    // job workers may read what it allocated, which stays valid through the following frame
+    inline frame_arena frame_memory;
+
+    // Allocator adaptors for array and string_t.  deallocate() is a no-op, the arena owns the memory
+    template<typename T, linear_arena& Arena> class arena_allocator {
+    public:
+        auto allocate(size_t n) -> T* { return static_cast<T*>(Arena.allocate(n * sizeof(T), alignof(T))); }
+        auto deallocate(T*) -> void {}
+
+        template<typename... Args> auto construct(T* ptr, Args&&... args) -> void { *ptr = T(args...); }
+        auto destroy(T* ptr) -> void { ptr->~T(); }
+    };
+
+    template<typename T> class frame_allocator {
+    public:
+        auto allocate(size_t n) -> T* { return static_cast<T*>(frame_memory.current().allocate(n * sizeof(T), alignof(T))); }
+        auto deallocate(T*) -> void {}
+
+        template<typename... Args> auto construct(T* ptr, Args&&... args) -> void { *ptr = T(args...); }
+        auto destroy(T* ptr) -> void { ptr->~T(); }
+    };
+}
+
+#endif // ENGINE_CORE_ARENA_H
@@ -9,9 +9,11 @@ namespace xc {
         template<typename... Args> explicit array(Args&&... args) { push_back(move(args)...); }
         //~array() { clear(); } // no destructor because it triggers SEH.  Call clear() manually for now
 
-        template<typename... Args> auto push_back(Args&&... args) -> void {
-            if ((_size + sizeof...(Args)) > _capacity) reserve(_capacity == 0 ? 1 : (_capacity + sizeof...(Args)) * 2);
+        // False, with the array unchanged, if growing failed
+        template<typename... Args> auto push_back(Args&&... args) -> bool {
+            if ((_size + sizeof...(Args)) > _capacity && !reserve(_capacity == 0 ? 1 : (_capacity + sizeof...(Args)) * 2)) return false;
             ((allocator.construct(_data + _size++, move(args))), ...);
+            return true;
         }
 
         auto pop_back() -> void {
@@ -29,9 +31,21 @@ namespace xc {
             _capacity = 0;
         }
 
-        auto reserve(size_t newCapacity) -> void {
+        // False, leaving the elements where they were, if the allocator failed
+        auto reserve(size_t newCapacity) -> bool {
             if (newCapacity > _capacity) {
+                // Relocatable elements can be moved by the allocator itself, which for large blocks remaps pages
+                // instead of copying them
+                if constexpr (is_trivially_relocatable<T> && requires { allocator.reallocate(_data, newCapacity); }) {
+                    T* newData = allocator.reallocate(_data, newCapacity);
+                    if (!newData) return false;
+                    _data = newData;
+                    _capacity = newCapacity;
+                    return true;
+                }
+
                 T* newData = allocator.allocate(newCapacity);
+                if (!newData) return false;
                 for (size_t i = 0; i < _size; ++i) {
                     allocator.construct(newData + i, move(_data[i]));
                     allocator.destroy(_data + i);
@@ -40,18 +54,21 @@ namespace xc {
                 _data = newData;
                 _capacity = newCapacity;
             }
+            return true;
         }
 
-        auto resize(size_t newSize) -> void {
+        // False, with the array unchanged, if growing failed
+        auto resize(size_t newSize) -> bool {
             if (newSize < _size) {
                 for (size_t i = newSize; i < _size; ++i)
                     allocator.destroy(_data + i);
             } else if (newSize > _size) {
-                if (newSize > _capacity) reserve(newSize);
+                if (newSize > _capacity && !reserve(newSize)) return false;
                 for (size_t i = _size; i < newSize; ++i)
                     allocator.construct(_data + i);
             }
             _size = newSize;
+            return true;
         }
 
         auto operator[](size_t index) const -> T const& { return _data[index]; }
@@ -72,6 +89,101 @@ namespace xc {
         size_t _capacity = 0u;
         Allocator allocator;
     };
+
+    // array with room for N elements inside the object; only growing past N touches the allocator.  The inline
+    // elements make it unsafe to copy bitwise, so copying is disabled
+    template<typename T, size_t N, typename Allocator = default_allocator<T>> class small_array {
+    public:
+        template<typename... Args> explicit small_array(Args&&... args) { push_back(move(args)...); }
+
+        small_array(small_array const&) = delete;
+        auto operator=(small_array const&) -> small_array& = delete;
+
+        // False, with the array unchanged, if growing failed
+        template<typename... Args> auto push_back(Args&&... args) -> bool {
+            if ((_size + sizeof...(Args)) > _capacity && !reserve((_capacity + sizeof...(Args)) * 2)) return false;
+            ((allocator.construct(_data + _size++, move(args))), ...);
+            return true;
+        }
+
+        auto pop_back() -> void {
+            if (_size > 0) {
+                --_size;
+                allocator.destroy(_data + _size);
+            }
+        }
+
+        // Also returns spilled storage to the allocator and goes back to the inline buffer
+        auto clear() -> void {
+            for (size_t i = 0; i < _size; ++i) allocator.destroy(_data + i);
+            if (!is_inline()) allocator.deallocate(_data);
+            _data = inline_data();
+            _size = 0;
+            _capacity = N;
+        }
+
+        // False, leaving the elements where they were, if the allocator failed
+        auto reserve(size_t newCapacity) -> bool {
+            if (newCapacity > _capacity) {
+                if constexpr (is_trivially_relocatable<T> && requires { allocator.reallocate(_data, newCapacity); }) {
+                    if (!is_inline()) {
+                        T* newData = allocator.reallocate(_data, newCapacity);
+                        if (!newData) return false;
+                        _data = newData;
+                        _capacity = newCapacity;
+                        return true;
+                    }
+                }
+
+                T* newData = allocator.allocate(newCapacity);
+                if (!newData) return false;
+                for (size_t i = 0; i < _size; ++i) {
+                    allocator.construct(newData + i, move(_data[i]));
+                    allocator.destroy(_data + i);
+                }
+                if (!is_inline()) allocator.deallocate(_data);
+                _data = newData;
+                _capacity = newCapacity;
+            }
+            return true;
+        }
+
+        // False, with the array unchanged, if growing failed
+        auto resize(size_t newSize) -> bool {
+            if (newSize < _size) {
+                for (size_t i = newSize; i < _size; ++i)
+                    allocator.destroy(_data + i);
+            } else if (newSize > _size) {
+                if (newSize > _capacity && !reserve(newSize)) return false;
+                for (size_t i = _size; i < newSize; ++i)
+                    allocator.construct(_data + i);
+            }
+            _size = newSize;
+            return true;
+        }
+
+        auto operator[](size_t index) const -> T const& { return _data[index]; }
+        auto operator[](size_t index) -> T& { return _data[index]; }
+        [[nodiscard]] auto capacity() const -> size_t { return _capacity; }
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto is_inline() const -> bool { return _data == inline_data(); }
+        auto data() const -> T const* { return _data; }
+        auto data() -> T* { return _data; }
+
+        auto begin() -> T* { return _data; }
+        auto end() -> T* { return _data + _size; }
+        auto begin() const -> T const* { return _data; }
+        auto end() const -> T const* { return _data + _size; }
+
+    private:
+        alignas(T) unsigned char _inline[N * sizeof(T)];
+        T* _data = inline_data();
+        size_t _size = 0u;
+        size_t _capacity = N;
+        Allocator allocator;
+
+        auto inline_data() const -> T* { return reinterpret_cast<T*>(const_cast<unsigned char*>(_inline)); }
+    };
 }
 
 #endif
\ No newline at end of file
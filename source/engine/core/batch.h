@@ -0,0 +1,259 @@
+#ifndef ENGINE_CORE_BATCH_H
+#define ENGINE_CORE_BATCH_H
+
+#include <engine/core/types.h>
+#include <engine/core/cpu.h>
+#include <engine/core/math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define BATCH_SIMD 1
+#endif
+
+// Kernels over structure of arrays streams, such as the x, y and z columns of a soa_array.  Each one runs 8 lanes
+// at a time with AVX2 when the CPU has it, 4 with SSE2 otherwise, and finishes the remainder with scalar code that
+// performs the same operations in the same order, so results don't depend on the path or on where the tail starts.
+// Outputs may alias inputs exactly (in place), but not partially
+namespace xc::batch {
+    struct vector3_stream {
+        float* x;
+        float* y;
+        float* z;
+    };
+
+    // out = m * (in, w).  w is 1 for points and 0 for directions; the projective row is ignored
+    auto inline transform_scalar(matrix4 const& m, float w, vector3_stream in, vector3_stream out, size_t begin, size_t count) -> void {
+        auto const tx = m.w.x * w, ty = m.w.y * w, tz = m.w.z * w;
+        for (auto i = begin; i < count; ++i) {
+            auto const x = in.x[i], y = in.y[i], z = in.z[i];
+            out.x[i] = m.x.x * x + m.y.x * y + m.z.x * z + tx;
+            out.y[i] = m.x.y * x + m.y.y * y + m.z.y * z + ty;
+            out.z[i] = m.x.z * x + m.y.z * y + m.z.z * z + tz;
+        }
+    }
+
+    auto inline integrate_scalar(vector3_stream position, vector3_stream velocity, float dt, size_t begin, size_t count) -> void {
+        for (auto i = begin; i < count; ++i) {
+            position.x[i] = position.x[i] + velocity.x[i] * dt;
+            position.y[i] = position.y[i] + velocity.y[i] * dt;
+            position.z[i] = position.z[i] + velocity.z[i] * dt;
+        }
+    }
+
+    auto inline normalize_scalar(vector3_stream in, vector3_stream out, size_t begin, size_t count) -> void {
+        for (auto i = begin; i < count; ++i) {
+            auto const x = in.x[i], y = in.y[i], z = in.z[i];
+            auto const length = sqrt(x * x + y * y + z * z);
+            out.x[i] = x / length;
+            out.y[i] = y / length;
+            out.z[i] = z / length;
+        }
+    }
+
+#if BATCH_SIMD
+    // Each SIMD kernel returns how many elements it processed; the caller finishes the rest
+    auto inline transform_sse2(matrix4 const& m, float w, vector3_stream in, vector3_stream out, size_t count) -> size_t {
+        auto const xx = _mm_set1_ps(m.x.x), xy = _mm_set1_ps(m.x.y), xz = _mm_set1_ps(m.x.z);
+        auto const yx = _mm_set1_ps(m.y.x), yy = _mm_set1_ps(m.y.y), yz = _mm_set1_ps(m.y.z);
+        auto const zx = _mm_set1_ps(m.z.x), zy = _mm_set1_ps(m.z.y), zz = _mm_set1_ps(m.z.z);
+        auto const tx = _mm_set1_ps(m.w.x * w), ty = _mm_set1_ps(m.w.y * w), tz = _mm_set1_ps(m.w.z * w);
+
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) {
+            auto const x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+            _mm_storeu_ps(out.x + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, x), _mm_mul_ps(yx, y)), _mm_mul_ps(zx, z)), tx));
+            _mm_storeu_ps(out.y + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xy, x), _mm_mul_ps(yy, y)), _mm_mul_ps(zy, z)), ty));
+            _mm_storeu_ps(out.z + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xz, x), _mm_mul_ps(yz, y)), _mm_mul_ps(zz, z)), tz));
+        }
+        return i;
+    }
+
+    TARGET_AVX2 auto inline transform_avx2(matrix4 const& m, float w, vector3_stream in, vector3_stream out, size_t count) -> size_t {
+        auto const xx = _mm256_set1_ps(m.x.x), xy = _mm256_set1_ps(m.x.y), xz = _mm256_set1_ps(m.x.z);
+        auto const yx = _mm256_set1_ps(m.y.x), yy = _mm256_set1_ps(m.y.y), yz = _mm256_set1_ps(m.y.z);
+        auto const zx = _mm256_set1_ps(m.z.x), zy = _mm256_set1_ps(m.z.y), zz = _mm256_set1_ps(m.z.z);
+        auto const tx = _mm256_set1_ps(m.w.x * w), ty = _mm256_set1_ps(m.w.y * w), tz = _mm256_set1_ps(m.w.z * w);
+
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) {
+            auto const x = _mm256_loadu_ps(in.x + i), y = _mm256_loadu_ps(in.y + i), z = _mm256_loadu_ps(in.z + i);
+            _mm256_storeu_ps(out.x + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xx, x), _mm256_mul_ps(yx, y)), _mm256_mul_ps(zx, z)), tx));
+            _mm256_storeu_ps(out.y + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xy, x), _mm256_mul_ps(yy, y)), _mm256_mul_ps(zy, z)), ty));
+            _mm256_storeu_ps(out.z + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(xz, x), _mm256_mul_ps(yz, y)), _mm256_mul_ps(zz, z)), tz));
+        }
+        return i;
+    }
+
+    auto inline integrate_sse2(vector3_stream position, vector3_stream velocity, float dt, size_t count) -> size_t {
+        auto const step = _mm_set1_ps(dt);
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(position.x + i, _mm_add_ps(_mm_loadu_ps(position.x + i), _mm_mul_ps(_mm_loadu_ps(velocity.x + i), step)));
+            _mm_storeu_ps(position.y + i, _mm_add_ps(_mm_loadu_ps(position.y + i), _mm_mul_ps(_mm_loadu_ps(velocity.y + i), step)));
+            _mm_storeu_ps(position.z + i, _mm_add_ps(_mm_loadu_ps(position.z + i), _mm_mul_ps(_mm_loadu_ps(velocity.z + i), step)));
+        }
+        return i;
+    }
+
+    TARGET_AVX2 auto inline integrate_avx2(vector3_stream position, vector3_stream velocity, float dt, size_t count) -> size_t {
+        auto const step = _mm256_set1_ps(dt);
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(position.x + i, _mm256_add_ps(_mm256_loadu_ps(position.x + i), _mm256_mul_ps(_mm256_loadu_ps(velocity.x + i), step)));
+            _mm256_storeu_ps(position.y + i, _mm256_add_ps(_mm256_loadu_ps(position.y + i), _mm256_mul_ps(_mm256_loadu_ps(velocity.y + i), step)));
+            _mm256_storeu_ps(position.z + i, _mm256_add_ps(_mm256_loadu_ps(position.z + i), _mm256_mul_ps(_mm256_loadu_ps(velocity.z + i), step)));
+        }
+        return i;
+    }
+
+    auto inline normalize_sse2(vector3_stream in, vector3_stream out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) {
+            auto const x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+            auto const length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            _mm_storeu_ps(out.x + i, _mm_div_ps(x, length));
+            _mm_storeu_ps(out.y + i, _mm_div_ps(y, length));
+            _mm_storeu_ps(out.z + i, _mm_div_ps(z, length));
+        }
+        return i;
+    }
+
+    TARGET_AVX2 auto inline normalize_avx2(vector3_stream in, vector3_stream out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) {
+            auto const x = _mm256_loadu_ps(in.x + i), y = _mm256_loadu_ps(in.y + i), z = _mm256_loadu_ps(in.z + i);
+            auto const length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+            _mm256_storeu_ps(out.x + i, _mm256_div_ps(x, length));
+            _mm256_storeu_ps(out.y + i, _mm256_div_ps(y, length));
+            _mm256_storeu_ps(out.z + i, _mm256_div_ps(z, length));
+        }
+        return i;
+    }
+
+    // Elementwise maps for the transcendentals in math.h
+    template<__m128 (*Kernel)(__m128)> auto inline map_sse2(float const* in, float* out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, Kernel(_mm_loadu_ps(in + i)));
+        return i;
+    }
+
+    template<__m256 (*Kernel)(__m256)> TARGET_AVX2 auto inline map_avx2(float const* in, float* out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) _mm256_storeu_ps(out + i, Kernel(_mm256_loadu_ps(in + i)));
+        return i;
+    }
+
+    template<__m128 (*Kernel)(__m128, __m128)> auto inline map_sse2(float const* a, float const* b, float* out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, Kernel(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        return i;
+    }
+
+    template<__m256 (*Kernel)(__m256, __m256)> TARGET_AVX2 auto inline map_avx2(float const* a, float const* b, float* out, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) _mm256_storeu_ps(out + i, Kernel(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        return i;
+    }
+
+    auto inline sincos_sse2(float const* in, float* out_sin, float* out_cos, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 4 <= count; i += 4) {
+            __m128 s, c;
+            simd::sincos(_mm_loadu_ps(in + i), s, c);
+            _mm_storeu_ps(out_sin + i, s);
+            _mm_storeu_ps(out_cos + i, c);
+        }
+        return i;
+    }
+
+    TARGET_AVX2 auto inline sincos_avx2(float const* in, float* out_sin, float* out_cos, size_t count) -> size_t {
+        auto i = size_t{};
+        for (; i + 8 <= count; i += 8) {
+            __m256 s, c;
+            simd::sincos(_mm256_loadu_ps(in + i), s, c);
+            _mm256_storeu_ps(out_sin + i, s);
+            _mm256_storeu_ps(out_cos + i, c);
+        }
+        return i;
+    }
+#endif
+
+    auto inline transform_points(matrix4 const& m, vector3_stream in, vector3_stream out, size_t count) -> void {
+        auto done = size_t{};
+#if BATCH_SIMD
+        done = cpu_has_avx2() ? transform_avx2(m, 1.f, in, out, count) : transform_sse2(m, 1.f, in, out, count);
+#endif
+        transform_scalar(m, 1.f, in, out, done, count);
+    }
+
+    // Like transform_points but without the translation, for velocities and normals under rigid transforms
+    auto inline transform_directions(matrix4 const& m, vector3_stream in, vector3_stream out, size_t count) -> void {
+        auto done = size_t{};
+#if BATCH_SIMD
+        done = cpu_has_avx2() ? transform_avx2(m, 0.f, in, out, count) : transform_sse2(m, 0.f, in, out, count);
+#endif
+        transform_scalar(m, 0.f, in, out, done, count);
+    }
+
+    // position += velocity * dt
+    auto inline integrate(vector3_stream position, vector3_stream velocity, float dt, size_t count) -> void {
+        auto done = size_t{};
+#if BATCH_SIMD
+        done = cpu_has_avx2() ? integrate_avx2(position, velocity, dt, count) : integrate_sse2(position, velocity, dt, count);
+#endif
+        integrate_scalar(position, velocity, dt, done, count);
+    }
+
+    // Undefined for zero length vectors
+    auto inline normalize(vector3_stream in, vector3_stream out, size_t count) -> void {
+        auto done = size_t{};
+#if BATCH_SIMD
+        done = cpu_has_avx2() ? normalize_avx2(in, out, count) : normalize_sse2(in, out, count);
+#endif
+        normalize_scalar(in, out, done, count);
+    }
+
+    // Transcendentals over streams, with the accuracy documented on the scalar forms in math.h.  Outputs may alias
+    // inputs exactly
+#if BATCH_SIMD
+#define BATCH_MAP(name, ...) (cpu_has_avx2() ? map_avx2<simd::name>(__VA_ARGS__) : map_sse2<simd::name>(__VA_ARGS__))
+#else
+#define BATCH_MAP(name, ...) size_t{}
+#endif
+
+    auto inline sin(float const* in, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(sin, in, out, count); i < count; ++i) out[i] = xc::sin(in[i]);
+    }
+
+    auto inline cos(float const* in, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(cos, in, out, count); i < count; ++i) out[i] = xc::cos(in[i]);
+    }
+
+    auto inline sincos(float const* in, float* out_sin, float* out_cos, size_t count) -> void {
+        auto done = size_t{};
+#if BATCH_SIMD
+        done = cpu_has_avx2() ? sincos_avx2(in, out_sin, out_cos, count) : sincos_sse2(in, out_sin, out_cos, count);
+#endif
+        for (auto i = done; i < count; ++i) xc::sincos(in[i], out_sin[i], out_cos[i]);
+    }
+
+    auto inline atan2(float const* y, float const* x, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(atan2, y, x, out, count); i < count; ++i) out[i] = xc::atan2(y[i], x[i]);
+    }
+
+    auto inline exp(float const* in, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(exp, in, out, count); i < count; ++i) out[i] = xc::exp(in[i]);
+    }
+
+    auto inline log(float const* in, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(log, in, out, count); i < count; ++i) out[i] = xc::log(in[i]);
+    }
+
+    auto inline pow(float const* x, float const* y, float* out, size_t count) -> void {
+        for (auto i = BATCH_MAP(pow, x, y, out, count); i < count; ++i) out[i] = xc::pow(x[i], y[i]);
+    }
+
+#undef BATCH_MAP
+}
+
+#endif // ENGINE_CORE_BATCH_H
@@ -0,0 +1,399 @@
+#ifndef ENGINE_CORE_BITSET_H
+#define ENGINE_CORE_BITSET_H
+
+#include <engine/core/types.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITSET_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BITSET_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace xc {
+    // Index of the lowest set bit (tzcnt/bsf).  Undefined for 0
+    auto inline count_trailing_zeros(uint64_t bits) -> uint32_t {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return index;
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+
+    auto inline popcount(uint64_t bits) -> uint32_t {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return static_cast<uint32_t>(__popcnt64(bits));
+#else
+        return static_cast<uint32_t>(__builtin_popcountll(bits));
+#endif
+    }
+
+    // Word array kernels shared by bitset and dynamic_bitset.  Bulk operations run four words per instruction with
+    // AVX2, two with SSE2, and finish the tail a word at a time
+    namespace bits {
+        auto static constexpr WORD_BITS = size_t{64};
+        auto static constexpr NOT_FOUND = ~size_t{};
+
+        auto constexpr word_count(size_t bits) -> size_t { return (bits + WORD_BITS - 1) / WORD_BITS; }
+
+        // Mask of the bits that are in use in the last word
+        auto constexpr tail_mask(size_t bits) -> uint64_t {
+            return bits % WORD_BITS ? (uint64_t{1} << (bits % WORD_BITS)) - 1 : ~uint64_t{};
+        }
+
+#if BITSET_AVX2
+        template<typename F, typename S> auto inline combine(uint64_t* destination, uint64_t const* source, size_t count, F&& vector, S&& scalar) -> void {
+            auto i = size_t{};
+            for (; i + 4 <= count; i += 4) {
+                auto const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(destination + i));
+                auto const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), vector(d, s));
+            }
+            for (; i < count; ++i) destination[i] = scalar(destination[i], source[i]);
+        }
+
+        auto inline bitwise_and(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m256i d, __m256i s) { return _mm256_and_si256(d, s); },
+                    [](uint64_t d, uint64_t s) { return d & s; });
+        }
+
+        auto inline bitwise_or(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m256i d, __m256i s) { return _mm256_or_si256(d, s); },
+                    [](uint64_t d, uint64_t s) { return d | s; });
+        }
+
+        auto inline bitwise_xor(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m256i d, __m256i s) { return _mm256_xor_si256(d, s); },
+                    [](uint64_t d, uint64_t s) { return d ^ s; });
+        }
+
+        // destination &= ~source
+        auto inline bitwise_and_not(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m256i d, __m256i s) { return _mm256_andnot_si256(s, d); },
+                    [](uint64_t d, uint64_t s) { return d & ~s; });
+        }
+
+        // Nibble lookup popcount (Mula): vpshufb counts each nibble, vpsadbw sums the bytes of every word
+        auto inline popcount(uint64_t const* words, size_t count) -> size_t {
+            auto const table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            auto const low = _mm256_set1_epi8(0x0f);
+            auto sums = _mm256_setzero_si256();
+
+            auto i = size_t{};
+            for (; i + 4 <= count; i += 4) {
+                auto const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words + i));
+                auto const counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+                                                    _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+                sums = _mm256_add_epi64(sums, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+            }
+
+            auto total = static_cast<size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                                             _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+            for (; i < count; ++i) total += xc::popcount(words[i]);
+            return total;
+        }
+
+        // First word at or after start that isn't zero, or count
+        auto inline find_nonzero(uint64_t const* words, size_t start, size_t count) -> size_t {
+            auto i = start;
+            for (; i + 4 <= count; i += 4) {
+                auto const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words + i));
+                if (!_mm256_testz_si256(v, v)) break;
+            }
+            for (; i < count; ++i) if (words[i]) return i;
+            return count;
+        }
+#elif BITSET_SSE2
+        template<typename F, typename S> auto inline combine(uint64_t* destination, uint64_t const* source, size_t count, F&& vector, S&& scalar) -> void {
+            auto i = size_t{};
+            for (; i + 2 <= count; i += 2) {
+                auto const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(destination + i));
+                auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), vector(d, s));
+            }
+            for (; i < count; ++i) destination[i] = scalar(destination[i], source[i]);
+        }
+
+        auto inline bitwise_and(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m128i d, __m128i s) { return _mm_and_si128(d, s); },
+                    [](uint64_t d, uint64_t s) { return d & s; });
+        }
+
+        auto inline bitwise_or(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m128i d, __m128i s) { return _mm_or_si128(d, s); },
+                    [](uint64_t d, uint64_t s) { return d | s; });
+        }
+
+        auto inline bitwise_xor(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m128i d, __m128i s) { return _mm_xor_si128(d, s); },
+                    [](uint64_t d, uint64_t s) { return d ^ s; });
+        }
+
+        // destination &= ~source
+        auto inline bitwise_and_not(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            combine(destination, source, count, [](__m128i d, __m128i s) { return _mm_andnot_si128(s, d); },
+                    [](uint64_t d, uint64_t s) { return d & ~s; });
+        }
+
+        // SSE2 has no byte shuffle, so counting stays a word at a time
+        auto inline popcount(uint64_t const* words, size_t count) -> size_t {
+            auto total = size_t{};
+            for (size_t i = 0; i < count; ++i) total += xc::popcount(words[i]);
+            return total;
+        }
+
+        // First word at or after start that isn't zero, or count
+        auto inline find_nonzero(uint64_t const* words, size_t start, size_t count) -> size_t {
+            auto i = start;
+            for (; i + 2 <= count; i += 2) {
+                auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(words + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xffff) break;
+            }
+            for (; i < count; ++i) if (words[i]) return i;
+            return count;
+        }
+#else
+        auto inline bitwise_and(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            for (size_t i = 0; i < count; ++i) destination[i] &= source[i];
+        }
+
+        auto inline bitwise_or(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            for (size_t i = 0; i < count; ++i) destination[i] |= source[i];
+        }
+
+        auto inline bitwise_xor(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            for (size_t i = 0; i < count; ++i) destination[i] ^= source[i];
+        }
+
+        auto inline bitwise_and_not(uint64_t* destination, uint64_t const* source, size_t count) -> void {
+            for (size_t i = 0; i < count; ++i) destination[i] &= ~source[i];
+        }
+
+        auto inline popcount(uint64_t const* words, size_t count) -> size_t {
+            auto total = size_t{};
+            for (size_t i = 0; i < count; ++i) total += xc::popcount(words[i]);
+            return total;
+        }
+
+        auto inline find_nonzero(uint64_t const* words, size_t start, size_t count) -> size_t {
+            for (auto i = start; i < count; ++i) if (words[i]) return i;
+            return count;
+        }
+#endif
+
+        // Index of the first set bit at or after start, or NOT_FOUND
+        auto inline find_next(uint64_t const* words, size_t count, size_t start) -> size_t {
+            auto word = start / WORD_BITS;
+            if (word >= count) return NOT_FOUND;
+
+            auto const first = words[word] & (~uint64_t{} << (start % WORD_BITS));
+            if (first) return word * WORD_BITS + count_trailing_zeros(first);
+
+            word = find_nonzero(words, word + 1, count);
+            return word < count ? word * WORD_BITS + count_trailing_zeros(words[word]) : NOT_FOUND;
+        }
+
+        // Calls function(size_t index) for every set bit in ascending order.  Empty words cost one test each
+        template<typename F> auto inline for_each_set(uint64_t const* words, size_t count, F&& function) -> void {
+            for (size_t i = 0; i < count; ++i) {
+                for (auto word = words[i]; word; word &= word - 1)
+                    function(i * WORD_BITS + count_trailing_zeros(word));
+            }
+        }
+
+        // Walks the set bits of a word array in ascending order
+        class set_bit_iterator {
+        public:
+            set_bit_iterator(uint64_t const* words, size_t index, size_t count) : _words{words}, _index{index}, _count{count} {
+                _word = _index < _count ? _words[_index] : 0u;
+                if (!_word) skip();
+            }
+
+            auto operator*() const -> size_t { return _index * WORD_BITS + count_trailing_zeros(_word); }
+
+            auto operator++() -> set_bit_iterator& {
+                _word &= _word - 1;
+                if (!_word) skip();
+                return *this;
+            }
+
+            auto operator==(set_bit_iterator const& other) const -> bool { return _index == other._index && _word == other._word; }
+            auto operator!=(set_bit_iterator const& other) const -> bool { return !(*this == other); }
+
+        private:
+            uint64_t const* _words;
+            size_t _index;
+            size_t _count;
+            uint64_t _word = 0u;
+
+            auto skip() -> void {
+                _index = _index < _count ? find_nonzero(_words, _index + 1, _count) : _count;
+                _word = _index < _count ? _words[_index] : 0u;
+            }
+        };
+
+        // begin()/end() pair so set bits can be used in range for loops
+        class set_bit_range {
+        public:
+            set_bit_range(uint64_t const* words, size_t count) : _words{words}, _count{count} {}
+
+            auto begin() const -> set_bit_iterator { return {_words, 0, _count}; }
+            auto end() const -> set_bit_iterator { return {_words, _count, _count}; }
+
+        private:
+            uint64_t const* _words;
+            size_t _count;
+        };
+    }
+
+    // Fixed size bitset stored inline.  Bits past N are always zero, so counts and searches need no masking
+    template<size_t N> class bitset {
+    public:
+        auto static constexpr WORD_COUNT = bits::word_count(N);
+
+        auto set(size_t index) -> void { _words[index / bits::WORD_BITS] |= bit_of(index); }
+        auto reset(size_t index) -> void { _words[index / bits::WORD_BITS] &= ~bit_of(index); }
+        auto assign(size_t index, bool value) -> void { value ? set(index) : reset(index); }
+        [[nodiscard]] auto test(size_t index) const -> bool { return (_words[index / bits::WORD_BITS] & bit_of(index)) != 0; }
+
+        auto set_all() -> void {
+            memset(_words, 0xff, sizeof(_words));
+            _words[WORD_COUNT - 1] &= bits::tail_mask(N);
+        }
+
+        auto clear() -> void { memset(_words, 0, sizeof(_words)); }
+
+        [[nodiscard]] auto count() const -> size_t { return bits::popcount(_words, WORD_COUNT); }
+        [[nodiscard]] auto any() const -> bool { return bits::find_nonzero(_words, 0, WORD_COUNT) < WORD_COUNT; }
+        [[nodiscard]] auto none() const -> bool { return !any(); }
+
+        // Index of the first set bit at or after start, or bits::NOT_FOUND
+        [[nodiscard]] auto find_first() const -> size_t { return bits::find_next(_words, WORD_COUNT, 0); }
+        [[nodiscard]] auto find_next(size_t start) const -> size_t { return bits::find_next(_words, WORD_COUNT, start); }
+
+        auto operator&=(bitset const& other) -> bitset& { bits::bitwise_and(_words, other._words, WORD_COUNT); return *this; }
+        auto operator|=(bitset const& other) -> bitset& { bits::bitwise_or(_words, other._words, WORD_COUNT); return *this; }
+        auto operator^=(bitset const& other) -> bitset& { bits::bitwise_xor(_words, other._words, WORD_COUNT); return *this; }
+        auto and_not(bitset const& other) -> bitset& { bits::bitwise_and_not(_words, other._words, WORD_COUNT); return *this; }
+
+        auto operator==(bitset const& other) const -> bool { return memcmp(_words, other._words, sizeof(_words)) == 0; }
+        auto operator!=(bitset const& other) const -> bool { return !(*this == other); }
+
+        template<typename F> auto for_each_set(F&& function) const -> void { bits::for_each_set(_words, WORD_COUNT, function); }
+        [[nodiscard]] auto set_bits() const -> bits::set_bit_range { return {_words, WORD_COUNT}; }
+
+        [[nodiscard]] auto size() const -> size_t { return N; }
+        auto words() -> uint64_t* { return _words; }
+        auto words() const -> uint64_t const* { return _words; }
+
+    private:
+        uint64_t _words[WORD_COUNT] = {};
+
+        auto static bit_of(size_t index) -> uint64_t { return uint64_t{1} << (index % bits::WORD_BITS); }
+    };
+
+    // Growable bitset.  Bits past size() are always zero.  Operations between two sets of different sizes only touch
+    // the words both have.  No destructor, call release() manually
+    template<memory_tag Tag = memory_tag::untagged> class dynamic_bitset {
+    public:
+        constexpr dynamic_bitset() = default;
+
+        // New bits are zero
+        auto resize(size_t size) -> bool {
+            auto const count = bits::word_count(size);
+            if (count > _capacity) {
+                auto capacity = _capacity ? _capacity : size_t{4};
+                while (capacity < count) capacity *= 2;
+                auto const words = static_cast<uint64_t*>(xc::reallocate(_words, capacity * sizeof(uint64_t), Tag));
+                if (!words) return false;
+                memset(words + _capacity, 0, (capacity - _capacity) * sizeof(uint64_t));
+                _words = words;
+                _capacity = capacity;
+            }
+
+            if (size < _size) {
+                // Zero the dropped bits so that growing again brings them back cleared
+                memset(_words + count, 0, (bits::word_count(_size) - count) * sizeof(uint64_t));
+                if (count) _words[count - 1] &= bits::tail_mask(size);
+            }
+            _size = size;
+            return true;
+        }
+
+        auto release() -> void {
+            xc::deallocate(_words, Tag);
+            _words = nullptr;
+            _size = 0;
+            _capacity = 0;
+        }
+
+        auto set(size_t index) -> void { _words[index / bits::WORD_BITS] |= bit_of(index); }
+        auto reset(size_t index) -> void { _words[index / bits::WORD_BITS] &= ~bit_of(index); }
+        auto assign(size_t index, bool value) -> void { value ? set(index) : reset(index); }
+        [[nodiscard]] auto test(size_t index) const -> bool { return (_words[index / bits::WORD_BITS] & bit_of(index)) != 0; }
+
+        auto set_all() -> void {
+            if (!_size) return;
+            memset(_words, 0xff, word_count() * sizeof(uint64_t));
+            _words[word_count() - 1] &= bits::tail_mask(_size);
+        }
+
+        auto clear() -> void {
+            if (_words) memset(_words, 0, word_count() * sizeof(uint64_t));
+        }
+
+        [[nodiscard]] auto count() const -> size_t { return bits::popcount(_words, word_count()); }
+        [[nodiscard]] auto any() const -> bool { return bits::find_nonzero(_words, 0, word_count()) < word_count(); }
+        [[nodiscard]] auto none() const -> bool { return !any(); }
+
+        // Index of the first set bit at or after start, or bits::NOT_FOUND
+        [[nodiscard]] auto find_first() const -> size_t { return bits::find_next(_words, word_count(), 0); }
+        [[nodiscard]] auto find_next(size_t start) const -> size_t { return bits::find_next(_words, word_count(), start); }
+
+        auto operator&=(dynamic_bitset const& other) -> dynamic_bitset& {
+            auto const common = shared_words(other);
+            bits::bitwise_and(_words, other._words, common);
+            if (word_count() > common) memset(_words + common, 0, (word_count() - common) * sizeof(uint64_t));
+            return *this;
+        }
+
+        auto operator|=(dynamic_bitset const& other) -> dynamic_bitset& { bits::bitwise_or(_words, other._words, shared_words(other)); return mask_tail(); }
+        auto operator^=(dynamic_bitset const& other) -> dynamic_bitset& { bits::bitwise_xor(_words, other._words, shared_words(other)); return mask_tail(); }
+        auto and_not(dynamic_bitset const& other) -> dynamic_bitset& { bits::bitwise_and_not(_words, other._words, shared_words(other)); return *this; }
+
+        template<typename F> auto for_each_set(F&& function) const -> void { bits::for_each_set(_words, word_count(), function); }
+        [[nodiscard]] auto set_bits() const -> bits::set_bit_range { return {_words, word_count()}; }
+
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto word_count() const -> size_t { return bits::word_count(_size); }
+        auto words() -> uint64_t* { return _words; }
+        auto words() const -> uint64_t const* { return _words; }
+
+    private:
+        uint64_t* _words = nullptr;
+        size_t _size = 0u;
+        size_t _capacity = 0u;
+
+        auto static bit_of(size_t index) -> uint64_t { return uint64_t{1} << (index % bits::WORD_BITS); }
+
+        auto shared_words(dynamic_bitset const& other) const -> size_t {
+            return word_count() < other.word_count() ? word_count() : other.word_count();
+        }
+
+        // A longer other may carry set bits past our size in the shared last word
+        auto mask_tail() -> dynamic_bitset& {
+            if (_size) _words[word_count() - 1] &= bits::tail_mask(_size);
+            return *this;
+        }
+    };
+}
+
+#endif // ENGINE_CORE_BITSET_H
@@ -0,0 +1,240 @@
+#ifndef ENGINE_CORE_CONCURRENT_HASH_H
+#define ENGINE_CORE_CONCURRENT_HASH_H
+
+#include <engine/core/types.h>
+#include <engine/core/epoch.h>
+#include <engine/core/hash.h>
+#include <engine/core/spin_lock.h>
+
+namespace xc {
+    // Hash map for read-mostly data shared between threads.  Buckets are chains of immutable nodes: readers walk them
+    // without locks inside an epoch guard, and writers link in replacement nodes under one of 64 striped locks, picked
+    // by the low hash bits so every node in a bucket shares a stripe.  Growing locks every stripe and publishes a
+    // copied table.  Replaced nodes and tables are retired to the epoch domain, so they stay valid for readers that
+    // can still see them.
+    //
+    // Lookups copy the value out; use visit() to read it in place.  release() and the destructor must not race with
+    // other calls
+    template<typename Key, typename Value, memory_tag Tag = memory_tag::untagged> class concurrent_hash {
+    public:
+        concurrent_hash() = default;
+        ~concurrent_hash() { release(); }
+
+        concurrent_hash(concurrent_hash const&) = delete;
+        auto operator=(concurrent_hash const&) -> concurrent_hash& = delete;
+
+        template<typename K> auto find(K const& key, Value& value) const -> bool {
+            epoch::guard guard;
+            auto const n = find_node(key, hash_key(key));
+            return n && (value = n->value, true);
+        }
+
+        // Calls function(Value const&) while the value can't be reclaimed.  Returns false if the key is missing
+        template<typename K, typename F> auto visit(K const& key, F&& function) const -> bool {
+            epoch::guard guard;
+            auto const n = find_node(key, hash_key(key));
+            if (n) function(static_cast<Value const&>(n->value));
+            return n != nullptr;
+        }
+
+        template<typename K> [[nodiscard]] auto contains(K const& key) const -> bool {
+            epoch::guard guard;
+            return find_node(key, hash_key(key)) != nullptr;
+        }
+
+        // Inserts the pair unless the key is already present.  Returns false if it was
+        auto insert(Key const& key, Value const& value) -> bool { return write(key, value, false); }
+        auto insert_or_assign(Key const& key, Value const& value) -> void { write(key, value, true); }
+
+        template<typename K> auto remove(K const& key) -> bool {
+            auto const h = hash_key(key);
+            auto& lock = _stripes[h & (STRIPE_COUNT - 1)].lock;
+            lock.lock();
+
+            auto const t = _table.load(std::memory_order_relaxed);
+            auto const link = t ? find_link(t, key, h) : nullptr;
+            if (!link) {
+                lock.unlock();
+                return false;
+            }
+
+            auto const n = link->load(std::memory_order_relaxed);
+            link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+            _size.fetch_sub(1u, std::memory_order_relaxed);
+            lock.unlock();
+
+            epoch::retire(n, free_node);
+            return true;
+        }
+
+        auto clear() -> void {
+            lock_all();
+            auto const t = _table.load(std::memory_order_relaxed);
+            _table.store(t ? allocate_table(t->mask + 1) : nullptr, std::memory_order_release);
+            _size.store(0u, std::memory_order_relaxed);
+            unlock_all();
+
+            if (t) epoch::retire(t, free_table);
+        }
+
+        auto release() -> void {
+            if (auto const t = _table.exchange(nullptr, std::memory_order_relaxed)) free_table(t);
+            _size.store(0u, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] auto size() const -> size_t { return _size.load(std::memory_order_relaxed); }
+
+    private:
+        struct node {
+            std::atomic<node*> next;
+            uint64_t hash;
+            Key key;
+            Value value;
+        };
+
+        // Bucket heads follow the header in the same block
+        struct table {
+            size_t mask;
+        };
+
+        struct alignas(64) stripe {
+            spin_lock lock;
+        };
+
+        auto static constexpr STRIPE_COUNT = size_t{64};
+        auto static constexpr MIN_BUCKETS = size_t{64};
+
+        std::atomic<table*> _table = nullptr;
+        std::atomic<size_t> _size = 0u;
+        stripe _stripes[STRIPE_COUNT];
+
+        auto static buckets_of(table* t) -> std::atomic<node*>* { return reinterpret_cast<std::atomic<node*>*>(t + 1); }
+
+        auto static allocate_table(size_t bucket_count) -> table* {
+            auto const bytes = sizeof(table) + bucket_count * sizeof(std::atomic<node*>);
+            auto const t = static_cast<table*>(xc::allocate(bytes, Tag));
+            memset(static_cast<void*>(t), 0, bytes);
+            t->mask = bucket_count - 1;
+            return t;
+        }
+
+        auto static allocate_node(uint64_t h, Key const& key, Value const& value, node* next) -> node* {
+            auto const n = static_cast<node*>(xc::allocate(sizeof(node), Tag));
+            memset(static_cast<void*>(n), 0, sizeof(node));
+            n->next.store(next, std::memory_order_relaxed);
+            n->hash = h;
+            n->key = key;
+            n->value = value;
+            return n;
+        }
+
+        auto static free_node(void* ptr) -> void {
+            auto const n = static_cast<node*>(ptr);
+            n->~node();
+            xc::deallocate(n, Tag);
+        }
+
+        auto static free_table(void* ptr) -> void {
+            auto const t = static_cast<table*>(ptr);
+            auto const buckets = buckets_of(t);
+            for (size_t i = 0; i <= t->mask; ++i) {
+                for (auto n = buckets[i].load(std::memory_order_relaxed); n;) {
+                    auto const next = n->next.load(std::memory_order_relaxed);
+                    free_node(n);
+                    n = next;
+                }
+            }
+            xc::deallocate(t, Tag);
+        }
+
+        template<typename K> auto find_node(K const& key, uint64_t h) const -> node* {
+            auto const t = _table.load(std::memory_order_acquire);
+            if (!t) return nullptr;
+
+            for (auto n = buckets_of(t)[h & t->mask].load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire))
+                if (n->hash == h && n->key == key) return n;
+            return nullptr;
+        }
+
+        // The link pointing at the key's node, for writers holding the stripe lock
+        template<typename K> auto static find_link(table* t, K const& key, uint64_t h) -> std::atomic<node*>* {
+            auto link = &buckets_of(t)[h & t->mask];
+            for (auto n = link->load(std::memory_order_relaxed); n; n = link->load(std::memory_order_relaxed)) {
+                if (n->hash == h && n->key == key) return link;
+                link = &n->next;
+            }
+            return nullptr;
+        }
+
+        auto write(Key const& key, Value const& value, bool assign) -> bool {
+            auto const h = hash_key(key);
+            auto& lock = _stripes[h & (STRIPE_COUNT - 1)].lock;
+
+            for (;;) {
+                lock.lock();
+                auto const t = _table.load(std::memory_order_relaxed);
+                if (!t || _size.load(std::memory_order_relaxed) > t->mask) {
+                    lock.unlock();
+                    grow(t);
+                    continue;
+                }
+
+                if (auto const link = find_link(t, key, h)) {
+                    if (!assign) {
+                        lock.unlock();
+                        return false;
+                    }
+
+                    auto const old = link->load(std::memory_order_relaxed);
+                    link->store(allocate_node(h, key, value, old->next.load(std::memory_order_relaxed)), std::memory_order_release);
+                    lock.unlock();
+
+                    epoch::retire(old, free_node);
+                    return true;
+                }
+
+                auto& bucket = buckets_of(t)[h & t->mask];
+                bucket.store(allocate_node(h, key, value, bucket.load(std::memory_order_relaxed)), std::memory_order_release);
+                _size.fetch_add(1u, std::memory_order_relaxed);
+                lock.unlock();
+                return true;
+            }
+        }
+
+        // Doubles the table unless another writer already replaced the one the caller saw
+        auto grow(table* expected) -> void {
+            lock_all();
+            auto const t = _table.load(std::memory_order_relaxed);
+            if (t != expected) {
+                unlock_all();
+                return;
+            }
+
+            auto const bigger = allocate_table(t ? (t->mask + 1) * 2 : MIN_BUCKETS);
+            if (t) {
+                auto const buckets = buckets_of(t);
+                auto const new_buckets = buckets_of(bigger);
+                for (size_t i = 0; i <= t->mask; ++i) {
+                    for (auto n = buckets[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+                        auto& bucket = new_buckets[n->hash & bigger->mask];
+                        bucket.store(allocate_node(n->hash, n->key, n->value, bucket.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+                    }
+                }
+            }
+            _table.store(bigger, std::memory_order_release);
+            unlock_all();
+
+            if (t) epoch::retire(t, free_table);
+        }
+
+        auto lock_all() -> void {
+            for (auto& s : _stripes) s.lock.lock();
+        }
+
+        auto unlock_all() -> void {
+            for (auto& s : _stripes) s.lock.unlock();
+        }
+    };
+}
+
+#endif // ENGINE_CORE_CONCURRENT_HASH_H
@@ -0,0 +1,57 @@
+#ifndef ENGINE_CORE_CPU_H
+#define ENGINE_CORE_CPU_H
+
+#include <engine/core/types.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+// Marks a function that may use AVX2 even when the rest of the build targets the baseline.  Only call it after
+// cpu_has_avx2() said yes
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace xc {
+    // AVX2 needs the instructions and an OS that saves the YMM registers on context switches (XCR0 bits 1 and 2)
+    auto inline detect_avx2() -> bool {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int registers[4];
+        __cpuid(registers, 1);
+        if (!(registers[2] & (1 << 27)) || !(registers[2] & (1 << 28))) return false;
+        if ((_xgetbv(0) & 0x6u) != 0x6u) return false;
+        __cpuidex(registers, 7, 0);
+        return (registers[1] & (1 << 5)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) return false;
+
+        unsigned xcr0_low, xcr0_high;
+        asm volatile ("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        if ((xcr0_low & 0x6u) != 0x6u) return false;
+
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_AVX2);
+#else
+        return false;
+#endif
+    }
+
+    // -1 until the first query.  Racing threads all store the same answer
+    inline constinit std::atomic<int32_t> avx2_support = -1;
+
+    auto inline cpu_has_avx2() -> bool {
+        auto supported = avx2_support.load(std::memory_order_relaxed);
+        if (supported < 0) {
+            supported = detect_avx2() ? 1 : 0;
+            avx2_support.store(supported, std::memory_order_relaxed);
+        }
+        return supported != 0;
+    }
+}
+
+#endif // ENGINE_CORE_CPU_H
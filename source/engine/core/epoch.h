@@ -0,0 +1,143 @@
+#ifndef ENGINE_CORE_EPOCH_H
+#define ENGINE_CORE_EPOCH_H
+
+#include <engine/core/types.h>
+#include <engine/core/spin_lock.h>
+
+// Epoch based reclamation for lock-free readers.  A reader publishes the global epoch while it is inside a guard, and
+// memory unlinked by a writer is retired with the epoch at unlink time.  It's freed once every active reader entered
+// at a later epoch, since those readers can no longer reach it.  Entering and leaving are a few plain stores, so
+// readers never wait on writers.
+//
+// Threads claim a participant slot on first use and keep it.  Call release_thread() before a thread exits
+namespace xc::epoch {
+    // Every job worker and the main thread (the job system's MAX_WORKERS, checked there), plus a few more such as the
+    // render thread
+    auto inline constexpr MAX_THREADS = 256u + 8u;
+    auto inline constexpr RECLAIM_THRESHOLD = 64u;
+
+    using deleter = void (*)(void*);
+
+    struct alignas(64) participant {
+        std::atomic<uint64_t> epoch;
+        std::atomic<uint32_t> owned;
+    };
+
+    struct retired {
+        retired* next;
+        void* ptr;
+        deleter free;
+        uint64_t epoch;
+    };
+
+    struct domain {
+        std::atomic<uint64_t> epoch = 1u;
+        participant participants[MAX_THREADS];
+        spin_lock lock;
+        retired* list;
+        uint32_t count;
+    };
+
+    // Slot is the participant index + 1, zero until claimed
+    struct thread_state {
+        uint32_t slot;
+        uint32_t depth;
+    };
+
+    inline constinit domain global_domain = {};
+    inline constinit thread_local thread_state current_thread = {};
+
+    // More threads than slots is a bug: break into the debugger, then wait for an exiting thread to release one
+    auto inline claim_slot() -> uint32_t {
+        for (auto reported = false;; reported = true) {
+            for (auto i = 0u; i < MAX_THREADS; ++i) {
+                auto& p = global_domain.participants[i];
+                if (!p.owned.load(std::memory_order_relaxed) && !p.owned.exchange(1u, std::memory_order_acquire)) return i + 1u;
+            }
+            if (!reported) DEBUG_BREAK;
+            CPU_PAUSE();
+        }
+    }
+
+    // Guards nest; only the outermost one publishes an epoch
+    auto inline enter() -> void {
+        auto& t = current_thread;
+        if (t.depth++ > 0) return;
+        if (!t.slot) t.slot = claim_slot();
+
+        global_domain.participants[t.slot - 1].epoch.store(global_domain.epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    auto inline leave() -> void {
+        auto& t = current_thread;
+        if (--t.depth > 0) return;
+        global_domain.participants[t.slot - 1].epoch.store(0u, std::memory_order_release);
+    }
+
+    // Frees everything retired before the oldest active reader entered
+    auto inline reclaim() -> void {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto oldest = ~uint64_t{};
+        for (auto& p : global_domain.participants) {
+            auto const e = p.epoch.load(std::memory_order_acquire);
+            if (e && e < oldest) oldest = e;
+        }
+
+        retired* expired = nullptr;
+        global_domain.lock.lock();
+        for (auto link = &global_domain.list; *link;) {
+            auto const r = *link;
+            if (r->epoch < oldest) {
+                *link = r->next;
+                r->next = expired;
+                expired = r;
+                --global_domain.count;
+            } else {
+                link = &r->next;
+            }
+        }
+        global_domain.lock.unlock();
+
+        while (expired) {
+            auto const next = expired->next;
+            expired->free(expired->ptr);
+            xc::deallocate(expired, memory_tag::core);
+            expired = next;
+        }
+    }
+
+    // ptr must already be unreachable for readers that enter from now on
+    auto inline retire(void* ptr, deleter free) -> void {
+        auto const r = static_cast<retired*>(xc::allocate(sizeof(retired), memory_tag::core));
+        r->ptr = ptr;
+        r->free = free;
+        r->epoch = global_domain.epoch.fetch_add(1u, std::memory_order_acq_rel);
+
+        global_domain.lock.lock();
+        r->next = global_domain.list;
+        global_domain.list = r;
+        auto const count = ++global_domain.count;
+        global_domain.lock.unlock();
+
+        if (count >= RECLAIM_THRESHOLD) reclaim();
+    }
+
+    auto inline release_thread() -> void {
+        auto& t = current_thread;
+        if (!t.slot) return;
+        global_domain.participants[t.slot - 1].owned.store(0u, std::memory_order_release);
+        t.slot = 0u;
+    }
+
+    class guard {
+    public:
+        guard() { enter(); }
+        ~guard() { leave(); }
+
+        guard(guard const&) = delete;
+        auto operator=(guard const&) -> guard& = delete;
+    };
+}
+
+#endif // ENGINE_CORE_EPOCH_H
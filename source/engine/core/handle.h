@@ -0,0 +1,36 @@
+#ifndef ENGINE_CORE_HANDLE_H
+#define ENGINE_CORE_HANDLE_H
+
+#include <engine/core/types.h>
+
+namespace xc {
+    // 32-bit generational handle: the low 20 bits index a slot, the high 12 bits hold the slot's generation when the
+    // handle was issued.  Generations start at 1, so a zero handle is never valid
+    template<typename T> struct handle {
+        auto static constexpr INDEX_BITS = 20u;
+        auto static constexpr INDEX_MASK = (1u << INDEX_BITS) - 1u;
+        auto static constexpr GENERATION_MASK = (1u << (32u - INDEX_BITS)) - 1u;
+
+        uint32_t value = 0u;
+
+        auto static constexpr make(uint32_t index, uint32_t generation) -> handle {
+            return {(generation & GENERATION_MASK) << INDEX_BITS | (index & INDEX_MASK)};
+        }
+
+        [[nodiscard]] constexpr auto index() const -> uint32_t { return value & INDEX_MASK; }
+        [[nodiscard]] constexpr auto generation() const -> uint32_t { return value >> INDEX_BITS; }
+
+        constexpr explicit operator bool() const { return value != 0u; }
+        constexpr explicit operator uint64_t() const { return value; }
+        constexpr auto operator==(handle const& other) const -> bool { return value == other.value; }
+        constexpr auto operator!=(handle const& other) const -> bool { return value != other.value; }
+    };
+
+    // Next generation for a freed slot, skipping 0 when the 12 bits wrap
+    template<typename T> auto constexpr next_generation(uint32_t generation) -> uint32_t {
+        auto const next = (generation + 1u) & handle<T>::GENERATION_MASK;
+        return next == 0u ? 1u : next;
+    }
+}
+
+#endif // ENGINE_CORE_HANDLE_H
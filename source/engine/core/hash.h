@@ -2,333 +2,282 @@
 #define ENGINE_CORE_HASH_MAP_H
 
 #include <engine/core/types.h>
+#include <engine/core/bitset.h>
 
-/*
-template <typename Key, typename Value> class hash {
-public:
-    hash() : _capacity{16}, _size{0}, threshold(_capacity * 0.75f), data{static_cast<entry*>(malloc(_capacity * sizeof(entry)))} {}
-    hash free(data); }
-
-    auto insert(const Key& key, const Value& value) -> void {
-        if (_size >= threshold) resize();
-
-        size_t index = find_index(key);
-        data[index] = { key, value, true };
-        ++_size;
-    }
-
-    auto find(const Key& key, Value& value) const -> bool {
-        auto index = find_index(key);
-        return (data[index].occupied && data[index].key == key) && (value = data[index].value, true);
-    }
-
-    auto remove(const Key& key) -> bool {
-        size_t index = find_index(key);
-        return (data[index].occupied && data[index].key == key) && (data[index].occupied = false, --_size, true);
-    }
-
-    auto clear() -> void {
-        for (size_t i = 0; i < _capacity; ++i) data[i].occupied = false;
-        _size = 0;
-    }
-
-private:
-    struct entry {
-        Key key;
-        Value value;
-        bool occupied;
-    };
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HASH_SSE2 1
+#endif
 
-    size_t _capacity, _size;
-    float threshold;
-    entry* data;
+namespace xc {
+    // Keys hash through their uint64_t conversion.  C strings hash like string_t so either can be used for lookups
+    template<typename K> auto hash_key(K const& key) -> uint64_t { return wyhash(static_cast<uint64_t>(key)); }
 
-    auto find_index(const Key& key) const -> size_t {
-        auto index = wyhash(static_cast<uint64_t>(key)) % _capacity;
-        for (auto probe = 1; data[index].occupied && data[index].key != key; ++probe) index = (index + probe * probe) % _capacity;
-        return index;
+    auto inline hash_key(char const* key) -> uint64_t {
+        auto length = size_t{};
+        while (key[length]) ++length;
+        return wyhash(wyhash(key, length));
     }
 
+    // Open addressing hash map in the style of Abseil's SwissTable.  Every slot has a control byte holding either
+    // the low 7 bits of the key's hash or an empty/deleted marker, and lookups compare 16 control bytes at a time.
+    // The rest of the hash picks the first group, and groups are probed triangularly so every group is visited once.
+    //
+    // Lookups take any type that hashes to the same value as Key and compares equal to it.  Pointers to values stay
+    // valid until the next insert that grows the table
+    template<typename Key, typename Value, memory_tag Tag = memory_tag::untagged> class hash {
+    public:
+        hash() = default;
+        ~hash() { release(); }
+
+        hash(hash const&) = delete;
+        auto operator=(hash const&) -> hash& = delete;
+
+        // Inserts the pair unless the key is already present.  Returns false if it was, or if the table had to grow
+        // and couldn't
+        auto insert(Key const& key, Value const& value) -> bool {
+            auto const h = hash_key(key);
+            if (find_index(key, h) != NOT_FOUND) return false;
+
+            auto const index = prepare_insert(h);
+            if (index == NOT_FOUND) return false;
+            assign(index, key, value);
+            return true;
+        }
 
-    auto resize() -> void {
-        auto newCapacity = _capacity * 2;
-        auto* newData = static_cast<entry*>(malloc(newCapacity * sizeof(entry)));
-
-        for (size_t i = 0; i < _capacity; ++i) {
-            if (data[i].occupied) {
-                size_t newIndex = find_index(data[i].key);
-
-                for (size_t probe = 1; newData[newIndex].occupied; ++probe)
-                    newIndex = (newIndex + probe * probe) % newCapacity;
-
-                newData[newIndex] = data[i];
+        // The stored value, or nullptr if the key was new and the table couldn't grow
+        auto insert_or_assign(Key const& key, Value const& value) -> Value* {
+            auto const h = hash_key(key);
+            auto index = find_index(key, h);
+            if (index != NOT_FOUND) {
+                _slots[index].value = value;
+            } else {
+                index = prepare_insert(h);
+                if (index == NOT_FOUND) return nullptr;
+                assign(index, key, value);
             }
+            return &_slots[index].value;
         }
 
-        free(data);
-        data = newData;
-        _capacity = newCapacity;
-        threshold = _capacity * 0.75f;
-    }
-};
-*/
-
-
-template <typename Key, typename Value>
-class hash {
-public:
-    hash() : capacity(16), size(0), threshold(capacity * 0.75f), data(static_cast<entry*>(malloc(capacity * sizeof(entry)))), occupancy(static_cast<uint8_t*>(malloc((capacity + 7) / 8))) {
-        clear();
-    }
-
-    ~hash() {
-        free(data);
-        free(occupancy);
-    }
+        template<typename K> auto find(K const& key) -> Value* {
+            auto const index = find_index(key, hash_key(key));
+            return index != NOT_FOUND ? &_slots[index].value : nullptr;
+        }
 
-    auto insert(const Key& key, const Value& value) -> void {
-        if (size >= threshold)
-            resize();
+        template<typename K> auto find(K const& key) const -> Value const* {
+            auto const index = find_index(key, hash_key(key));
+            return index != NOT_FOUND ? &_slots[index].value : nullptr;
+        }
 
-        size_t index = find_index(key);
-        data[index] = { key, value };
-        set_occupancy(index);
-        ++size;
-    }
+        template<typename K> auto find(K const& key, Value& value) const -> bool {
+            auto const found = find(key);
+            return found && (value = *found, true);
+        }
 
-    auto find(const Key& key, Value& value) const -> bool {
-        size_t index = find_index(key);
-        if (is_occupied(index) && data[index].key == key) {
-            value = data[index].value;
-            return true;
+        template<typename K> [[nodiscard]] auto contains(K const& key) const -> bool {
+            return find_index(key, hash_key(key)) != NOT_FOUND;
         }
-        return false;
-    }
 
-    auto remove(const Key& key) -> bool {
-        size_t index = find_index(key);
-        if (is_occupied(index) && data[index].key == key) {
-            clear_occupancy(index);
-            --size;
+        // The slot becomes a tombstone unless its group still has an empty slot, in which case no probe sequence
+        // can run through it and it goes straight back to empty
+        template<typename K> auto remove(K const& key) -> bool {
+            auto const index = find_index(key, hash_key(key));
+            if (index == NOT_FOUND) return false;
+
+            destroy(index);
+            if (group_at(index & ~(GROUP_WIDTH - 1)).match(EMPTY)) {
+                _control[index] = EMPTY;
+                ++_growth_left;
+            } else {
+                _control[index] = DELETED;
+            }
+            --_size;
             return true;
         }
-        return false;
-    }
 
-    auto clear() -> void {
-        size = 0;
-        memset(occupancy, 0, (capacity + 7) / 8);
-    }
+        auto clear() -> void {
+            for (size_t i = 0; i < _capacity; ++i)
+                if (is_full(_control[i])) destroy(i);
+            if (_control) memset(_control, EMPTY, _capacity);
+            _size = 0;
+            _growth_left = growth_of(_capacity);
+        }
 
-private:
-    struct entry {
-        Key key;
-        Value value;
-    };
+        // Makes room for count entries without growing.  False, with the table unchanged, if allocating failed
+        auto reserve(size_t count) -> bool {
+            if (count <= _size + _growth_left) return true;
+            auto capacity = _capacity ? _capacity : MIN_CAPACITY;
+            while (growth_of(capacity) < count) capacity *= 2;
+            return rehash(capacity);
+        }
 
-    size_t capacity;
-    size_t size;
-    float threshold;
-    entry* data;
-    uint8_t* occupancy;
+        auto release() -> void {
+            clear();
+            xc::deallocate(_control, Tag);
+            _control = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+            _growth_left = 0;
+        }
 
-    auto find_index(const Key& key) const -> size_t {
-        auto hash = wyhash(static_cast<uint64_t>(key));
-        size_t index = hash % capacity;
-        size_t probe = 1;
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto capacity() const -> size_t { return _capacity; }
 
-        while (is_occupied(index) && data[index].key != key)
-            index = (index + probe * probe) % capacity;
+        // Scans a group of control bytes at a time and only visits the full slots in it
+        template<typename F> auto for_each(F&& function) -> void {
+            for (size_t base = 0; base < _capacity; base += GROUP_WIDTH) {
+                for (auto full = ~group_at(base).match_empty_or_deleted() & 0xffffu; full; full &= full - 1) {
+                    auto const i = base + count_trailing_zeros(full);
+                    function(static_cast<Key const&>(_slots[i].key), _slots[i].value);
+                }
+            }
+        }
 
-        return index;
-    }
+    private:
+        struct entry {
+            Key key;
+            Value value;
+        };
 
-    auto resize() -> void {
-        size_t newCapacity = capacity * 2;
-        entry* newData = static_cast<entry*>(malloc(newCapacity * sizeof(entry)));
-        uint8_t* newOccupancy = static_cast<uint8_t*>(malloc((newCapacity + 7) / 8));
-        memset(newOccupancy, 0, (newCapacity + 7) / 8);
+        auto static constexpr GROUP_WIDTH = size_t{16};
+        auto static constexpr MIN_CAPACITY = size_t{16};
+        auto static constexpr NOT_FOUND = ~size_t{};
 
-        for (size_t i = 0; i < capacity; ++i) {
-            if (is_occupied(i)) {
-                size_t newIndex = find_index(data[i].key);
-                size_t probe = 1;
+        // Full slots hold the 7 bit hash with the top bit clear
+        auto static constexpr EMPTY = uint8_t{0x80};
+        auto static constexpr DELETED = uint8_t{0xfe};
 
-                while (is_occupied(newIndex))
-                    newIndex = (newIndex + probe * probe) % newCapacity;
+        // Bit i set for every control byte in a group that matched
+        struct group {
+            uint8_t const* control;
 
-                newData[newIndex] = data[i];
-                set_occupancy(newIndex);
+#if HASH_SSE2
+            [[nodiscard]] auto match(uint8_t byte) const -> uint32_t {
+                auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(control));
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(byte)))));
             }
-        }
 
-        free(data);
-        free(occupancy);
-        data = newData;
-        occupancy = newOccupancy;
-        capacity = newCapacity;
-        threshold = capacity * 0.75f;
-    }
+            [[nodiscard]] auto match_empty_or_deleted() const -> uint32_t {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(control))));
+            }
+#else
+            [[nodiscard]] auto match(uint8_t byte) const -> uint32_t {
+                auto mask = 0u;
+                for (auto i = 0u; i < GROUP_WIDTH; ++i) mask |= static_cast<uint32_t>(control[i] == byte) << i;
+                return mask;
+            }
 
-    auto is_occupied(size_t index) const -> bool {
-        return (occupancy[index / 8] >> (index % 8)) & 1;
-    }
+            [[nodiscard]] auto match_empty_or_deleted() const -> uint32_t {
+                auto mask = 0u;
+                for (auto i = 0u; i < GROUP_WIDTH; ++i) mask |= static_cast<uint32_t>(control[i] >> 7) << i;
+                return mask;
+            }
+#endif
+        };
 
-    auto set_occupancy(size_t index) -> void {
-        occupancy[index / 8] |= (1 << (index % 8));
-    }
+        uint8_t* _control = nullptr;
+        entry* _slots = nullptr;
+        size_t _capacity = 0;
+        size_t _size = 0;
+        size_t _growth_left = 0;
 
-    auto clear_occupancy(size_t index) -> void {
-        occupancy[index / 8] &= ~(1 << (index % 8));
-    }
-};
+        // Maximum load of 7/8, counting tombstones
+        auto static growth_of(size_t capacity) -> size_t { return capacity - capacity / 8; }
 
+        auto static is_full(uint8_t control) -> bool { return (control & 0x80) == 0; }
+        auto static h1(uint64_t h) -> size_t { return h >> 7; }
+        auto static h2(uint64_t h) -> uint8_t { return static_cast<uint8_t>(h & 0x7f); }
 
-/*  Separate chaning impl
-template <typename Key, typename Value>
-class hash {
-public:
-    hash() : _capacity(16), _size(0), threshold(_capacity * 0.75f), data(static_cast<entry**>(malloc(_capacity * sizeof(entry*)))) {
-        clear();
-    }
+        auto group_at(size_t index) const -> group { return {_control + index}; }
 
-    hash
-        for (size_t i = 0; i < _capacity; ++i) {
-            entry* current = data[i];
-            while (current != nullptr) {
-                entry* next = current->next;
-                delete current;
-                current = next;
-            }
-        }
-        free(data);
-    }
+        template<typename K> auto find_index(K const& key, uint64_t h) const -> size_t {
+            if (!_control) return NOT_FOUND;
 
-    auto insert(const Key& key, const Value& value) -> void {
-        if (_size >= threshold)
-            resize();
-
-        size_t index = hash_function(key) % _capacity;
-        entry* newEntry = new entry{ key, value };
-
-        if (data[index] == nullptr) {
-            data[index] = newEntry;
-        } else {
-            entry* current = data[index];
-            while (current->next != nullptr) {
-                if (current->key == key) {
-                    current->value = value;  // Update existing value
-                    delete newEntry;  // Discard new entry
-                    return;
+            auto const group_mask = _capacity / GROUP_WIDTH - 1;
+            auto position = h1(h) & group_mask;
+            for (size_t step = 1;; ++step) {
+                auto const g = group_at(position * GROUP_WIDTH);
+                for (auto bits = g.match(h2(h)); bits; bits &= bits - 1) {
+                    auto const index = position * GROUP_WIDTH + count_trailing_zeros(bits);
+                    if (_slots[index].key == key) return index;
                 }
-                current = current->next;
+                if (g.match(EMPTY)) return NOT_FOUND;
+                position = (position + step) & group_mask;
             }
-            current->next = newEntry;
         }
 
-        ++_size;
-    }
-
-    auto find(const Key& key, Value& value) const -> bool {
-        size_t index = hash_function(key) % _capacity;
-        entry* current = data[index];
-
-        while (current != nullptr) {
-            if (current->key == key) {
-                value = current->value;
-                return true;
+        // First empty or deleted slot on the key's probe sequence.  The table always has one since it never fills
+        auto find_free(uint64_t h) const -> size_t {
+            auto const group_mask = _capacity / GROUP_WIDTH - 1;
+            auto position = h1(h) & group_mask;
+            for (size_t step = 1;; ++step) {
+                if (auto const bits = group_at(position * GROUP_WIDTH).match_empty_or_deleted())
+                    return position * GROUP_WIDTH + count_trailing_zeros(bits);
+                position = (position + step) & group_mask;
             }
-            current = current->next;
         }
 
-        return false;
-    }
-
-    auto remove(const Key& key) -> bool {
-        size_t index = hash_function(key) % _capacity;
-        entry* current = data[index];
-        entry* previous = nullptr;
-
-        while (current != nullptr) {
-            if (current->key == key) {
-                if (previous == nullptr) {
-                    data[index] = current->next;
-                } else {
-                    previous->next = current->next;
-                }
-                delete current;
-                --_size;
-                return true;
+        // NOT_FOUND if the table had to grow and couldn't
+        auto prepare_insert(uint64_t h) -> size_t {
+            auto index = _control ? find_free(h) : NOT_FOUND;
+            if (index == NOT_FOUND || (_growth_left == 0 && _control[index] == EMPTY)) {
+                // Mostly tombstones: clean up in place rather than doubling
+                auto const capacity = _capacity && _size < growth_of(_capacity) / 2 ? _capacity : (_capacity ? _capacity * 2 : MIN_CAPACITY);
+                if (!rehash(capacity)) return NOT_FOUND;
+                index = find_free(h);
             }
-            previous = current;
-            current = current->next;
-        }
 
-        return false;
-    }
-
-    auto clear() -> void {
-        for (size_t i = 0; i < _capacity; ++i) {
-            entry* current = data[i];
-            while (current != nullptr) {
-                entry* next = current->next;
-                delete current;
-                current = next;
-            }
-            data[i] = nullptr;
+            if (_control[index] == EMPTY) --_growth_left;
+            _control[index] = h2(h);
+            ++_size;
+            return index;
         }
-        _size = 0;
-    }
 
-private:
-    struct entry {
-        Key key;
-        Value value;
-        entry* next;
-    };
+        auto assign(size_t index, Key const& key, Value const& value) -> void {
+            _slots[index].key = key;
+            _slots[index].value = value;
+        }
 
-    size_t _capacity;
-    size_t _size;
-    float threshold;
-    entry** data;
-
-    auto resize() -> void {
-        size_t newCapacity = _capacity * 2;
-        entry** newData = static_cast<entry**>(malloc(newCapacity * sizeof(entry*)));
-        memset(newData, 0, newCapacity * sizeof(entry*));
-
-        for (size_t i = 0; i < _capacity; ++i) {
-            entry* current = data[i];
-            while (current != nullptr) {
-                entry* next = current->next;
-                size_t newIndex = hash_function(current->key) % newCapacity;
-
-                if (newData[newIndex] == nullptr) {
-                    newData[newIndex] = current;
-                    current->next = nullptr;
-                } else {
-                    current->next = newData[newIndex];
-                    newData[newIndex] = current;
-                }
+        // Leaves the slot zeroed, which is what assign() expects to write over
+        auto destroy(size_t index) -> void {
+            _slots[index].~entry();
+            memset(static_cast<void*>(_slots + index), 0, sizeof(entry));
+        }
 
-                current = next;
+        // Control bytes and slots share one block, with the slots after the control bytes.  On failure the old table
+        // is left as it was
+        auto rehash(size_t capacity) -> bool {
+            auto const slot_offset = (capacity + alignof(entry) - 1) & ~(alignof(entry) - 1);
+            auto const block = static_cast<uint8_t*>(xc::allocate(slot_offset + capacity * sizeof(entry), Tag));
+            if (!block) return false;
+            auto const old_control = _control;
+            auto const old_slots = _slots;
+            auto const old_capacity = _capacity;
+
+            _control = block;
+            _slots = reinterpret_cast<entry*>(block + slot_offset);
+            _capacity = capacity;
+            _growth_left = growth_of(capacity) - _size;
+            memset(_control, EMPTY, capacity);
+            memset(static_cast<void*>(_slots), 0, capacity * sizeof(entry));
+
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (!is_full(old_control[i])) continue;
+
+                auto const h = hash_key(old_slots[i].key);
+                auto const index = find_free(h);
+                _control[index] = h2(h);
+                _slots[index].key = move(old_slots[i].key);
+                _slots[index].value = move(old_slots[i].value);
+                old_slots[i].~entry();
             }
-        }
 
-        free(data);
-        data = newData;
-        _capacity = newCapacity;
-        threshold = _capacity * 0.75f;
-    }
+            xc::deallocate(old_control, Tag);
+            return true;
+        }
+    };
+}
 
-    auto hash_function(const Key& key) const -> size_t {
-        // Custom hash function implementation for the Key type
-        // Modify this function to suit your specific needs
-        // Example: return std::hash<Key>{}(key);
-        // Ensure the hash function provides a good distribution of values
-        // and is compatible with the equality comparison operator (==)
-    }
-};
+#undef HASH_SSE2
 
-*/
 #endif
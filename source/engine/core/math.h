@@ -0,0 +1,844 @@
+#ifndef ENGINE_CORE_MATH_H
+#define ENGINE_CORE_MATH_H
+
+#include <engine/core/types.h>
+#include <engine/core/cpu.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define MATH_SSE2 1
+#endif
+
+#if defined(__AVX__)
+#define MATH_AVX 1
+#endif
+
+// Every operation below is a constexpr template over vector<T,N> and matrix<T,M,N>.  vector4 and matrix4 take an SSE
+// path at run time; constant evaluation always uses the scalar code, which doubles as the reference for the SIMD one
+#if MATH_SSE2
+#define MATH_SIMD_RETURN(condition, expression) \
+    if constexpr (condition) if (!__builtin_is_constant_evaluated()) return expression
+#else
+#define MATH_SIMD_RETURN(condition, expression)
+#endif
+
+namespace xc {
+    auto static constexpr PI = 3.14159265358979323846f;
+
+    template<typename T, int N> inline constexpr bool is_vector4 = false;
+    template<> inline constexpr bool is_vector4<float, 4> = true;
+
+    template<typename T, int M, int N> inline constexpr bool is_matrix4 = false;
+    template<> inline constexpr bool is_matrix4<float, 4, 4> = true;
+
+    // Scalars /////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename T> constexpr auto abs(T x) -> T { return x < T{} ? -x : x; }
+    template<typename T> constexpr auto min(T a, T b) -> T { return b < a ? b : a; }
+    template<typename T> constexpr auto max(T a, T b) -> T { return a < b ? b : a; }
+    template<typename T> constexpr auto clamp(T x, T low, T high) -> T { return min(max(x, low), high); }
+    template<typename T> constexpr auto lerp(T a, T b, T t) -> T { return a + (b - a) * t; }
+
+    // Newton's method for constant evaluation, where the instruction isn't available
+    template<typename T> constexpr auto sqrt_newton(T x) -> T {
+        if (!(x > T{})) return x == T{} ? T{} : (x - x) / (x - x);
+        auto y = x > T{1} ? x : T{1};
+        for (auto i = 0; i < 64; ++i) {
+            auto const next = (y + x / y) / T{2};
+            if (next >= y) break;
+            y = next;
+        }
+        return y;
+    }
+
+    // sqrt and rsqrt without the CRT
+    constexpr auto sqrt(float x) -> float {
+        if (!__builtin_is_constant_evaluated()) {
+#if MATH_SSE2
+            return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+#else
+            return __builtin_sqrtf(x);
+#endif
+        }
+        return sqrt_newton(x);
+    }
+
+    constexpr auto sqrt(double x) -> double {
+        if (!__builtin_is_constant_evaluated()) {
+#if MATH_SSE2
+            return _mm_cvtsd_f64(_mm_sqrt_sd(_mm_setzero_pd(), _mm_set_sd(x)));
+#else
+            return __builtin_sqrt(x);
+#endif
+        }
+        return sqrt_newton(x);
+    }
+
+    // The hardware estimate is good to 12 bits; one Newton step brings it to about 22
+    constexpr auto rsqrt(float x) -> float {
+#if MATH_SSE2
+        if (!__builtin_is_constant_evaluated()) {
+            auto const estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+            return estimate * (1.5f - 0.5f * x * estimate * estimate);
+        }
+#endif
+        return 1.f / sqrt(x);
+    }
+
+    // Transcendentals /////////////////////////////////////////////////////////////////////////////////////////////////
+    // Cephes style polynomial approximations.  The scalar functions and the 4 and 8 lane versions in simd:: perform the
+    // same operations in the same order, so every width gives bit identical results.  Errors below are the worst
+    // measured against double precision, in units in the last place of the correctly rounded result
+    template<typename To, typename From> constexpr auto bit_cast(From const& from) -> To { return __builtin_bit_cast(To, from); }
+
+    namespace approx {
+        // The quadrant is clamped so it fits an int; results past the limit are defined but meaningless
+        auto static constexpr SINCOS_LIMIT = 1.e9f;
+        auto static constexpr FOUR_OVER_PI = 1.27323954473516f;
+        auto static constexpr PI_OVER_4_HIGH = 0.78515625f;
+        auto static constexpr PI_OVER_4_MID = 2.4187564849853515625e-4f;
+        auto static constexpr PI_OVER_4_LOW = 3.77489497744594108e-8f;
+        auto static constexpr SIN_0 = -1.6666654611e-1f, SIN_1 = 8.3321608736e-3f, SIN_2 = -1.9515295891e-4f;
+        auto static constexpr COS_0 = 4.166664568298827e-2f, COS_1 = -1.388731625493765e-3f, COS_2 = 2.443315711809948e-5f;
+
+        auto static constexpr TAN_PI_OVER_8 = 0.414213562373095f;
+        auto static constexpr ATAN_0 = 8.05374449538e-2f, ATAN_1 = -1.38776856032e-1f, ATAN_2 = 1.99777106478e-1f, ATAN_3 = -3.33329491539e-1f;
+
+        // exp overflows above EXP_HIGH and is zero, even as a denormal, below EXP_LOW
+        auto static constexpr EXP_HIGH = 88.72283935546875f;
+        auto static constexpr EXP_LOW = -104.f;
+        auto static constexpr LOG2_E = 1.44269504088896341f;
+        auto static constexpr LN2_HIGH = 0.693359375f;
+        auto static constexpr LN2_LOW = -2.12194440e-4f;
+        auto static constexpr EXP_0 = 1.9875691500e-4f, EXP_1 = 1.3981999507e-3f, EXP_2 = 8.3334519073e-3f;
+        auto static constexpr EXP_3 = 4.1665795894e-2f, EXP_4 = 1.6666665459e-1f, EXP_5 = 5.0000001201e-1f;
+
+        // Adding and subtracting 1.5 * 2^23 rounds to the nearest integer for |x| < 2^22
+        auto static constexpr ROUNDING_MAGIC = 12582912.f;
+
+        auto static constexpr SQRT_HALF = 0.707106781186547524f;
+        auto static constexpr MIN_NORMAL = 1.17549435e-38f;
+        auto static constexpr LOG_0 = 7.0376836292e-2f, LOG_1 = -1.1514610310e-1f, LOG_2 = 1.1676998740e-1f;
+        auto static constexpr LOG_3 = -1.2420140846e-1f, LOG_4 = 1.4249322787e-1f, LOG_5 = -1.6668057665e-1f;
+        auto static constexpr LOG_6 = 2.0000714765e-1f, LOG_7 = -2.4999993993e-1f, LOG_8 = 3.3333331174e-1f;
+
+        auto static constexpr INFINITY_BITS = 0x7f800000u;
+        auto static constexpr NAN_BITS = 0x7fc00000u;
+        auto static constexpr SIGN_BIT = 0x80000000u;
+    }
+
+    // Reduces to [-pi/4, pi/4] around the nearest multiple of pi/2 in three steps, then picks the sine or cosine
+    // polynomial by quadrant.  For |x| <= 8192 the absolute error is below 1e-7, which is 1.6 ulp away from the zeros;
+    // accuracy falls off beyond that
+    constexpr auto sincos(float x, float& s, float& c) -> void {
+        using namespace approx;
+        auto const sign = bit_cast<uint32_t>(x) & SIGN_BIT;
+        auto const a = bit_cast<float>(bit_cast<uint32_t>(x) & ~SIGN_BIT);
+
+        auto const q = a < SINCOS_LIMIT ? a : SINCOS_LIMIT;
+        auto const j = (static_cast<int32_t>(q * FOUR_OVER_PI) + 1) & ~1;
+        auto const y = static_cast<float>(j);
+        auto const r = ((a - y * PI_OVER_4_HIGH) - y * PI_OVER_4_MID) - y * PI_OVER_4_LOW;
+        auto const r2 = r * r;
+
+        auto const ps = r + r * r2 * (SIN_0 + r2 * (SIN_1 + r2 * SIN_2));
+        auto const pc = 1.f - 0.5f * r2 + r2 * r2 * (COS_0 + r2 * (COS_1 + r2 * COS_2));
+
+        auto const swap = (j & 2) != 0;
+        auto const sine = swap ? pc : ps;
+        auto const cosine = swap ? ps : pc;
+        s = bit_cast<float>(bit_cast<uint32_t>(sine) ^ sign ^ (static_cast<uint32_t>(j & 4) << 29));
+        c = bit_cast<float>(bit_cast<uint32_t>(cosine) ^ (static_cast<uint32_t>((j + 2) & 4) << 29));
+    }
+
+    constexpr auto sin(float x) -> float { float s{}, c{}; sincos(x, s, c); return s; }
+    constexpr auto cos(float x) -> float { float s{}, c{}; sincos(x, s, c); return c; }
+
+    // Angle of (x, y) in [-pi, pi].  The ratio of the smaller to the larger magnitude is reduced below tan(pi/8) and
+    // the octant is restored afterwards.  Max error 3.1 ulp (absolute 3e-7); (0, 0) gives 0 or pi by the sign of x
+    // and takes the sign of y, as the C library does
+    constexpr auto atan2(float y, float x) -> float {
+        using namespace approx;
+        auto const ax = bit_cast<float>(bit_cast<uint32_t>(x) & ~SIGN_BIT);
+        auto const ay = bit_cast<float>(bit_cast<uint32_t>(y) & ~SIGN_BIT);
+        auto const high = max(ax, ay), low = min(ax, ay);
+        auto a = high == 0.f ? 0.f : low / high;
+
+        auto const reduce = a > TAN_PI_OVER_8;
+        a = reduce ? (a - 1.f) / (a + 1.f) : a;
+        auto const z = a * a;
+        auto r = (((ATAN_0 * z + ATAN_1) * z + ATAN_2) * z + ATAN_3) * z * a + a;
+        r = r + (reduce ? PI * 0.25f : 0.f);
+
+        r = ay > ax ? PI * 0.5f - r : r;
+        r = (bit_cast<uint32_t>(x) & SIGN_BIT) ? PI - r : r;
+        return bit_cast<float>(bit_cast<uint32_t>(r) | (bit_cast<uint32_t>(y) & SIGN_BIT));
+    }
+
+    // e^x = 2^n * e^r with |r| <= ln(2)/2.  The power of two is applied in two halves so results near the overflow
+    // and denormal ends stay exact.  Max error 1 ulp for normal results; NaN passes through
+    constexpr auto exp(float x) -> float {
+        using namespace approx;
+        if (x != x) return x;
+        if (x > EXP_HIGH) return bit_cast<float>(INFINITY_BITS);
+        x = x < EXP_LOW ? EXP_LOW : x;
+
+        auto const fn = (x * LOG2_E + ROUNDING_MAGIC) - ROUNDING_MAGIC;
+        auto const r = (x - fn * LN2_HIGH) - fn * LN2_LOW;
+        auto const r2 = r * r;
+        auto const p = (((((EXP_0 * r + EXP_1) * r + EXP_2) * r + EXP_3) * r + EXP_4) * r + EXP_5) * r2 + r + 1.f;
+
+        auto const n = static_cast<int32_t>(fn);
+        auto const half = n >> 1;
+        return p * bit_cast<float>(static_cast<uint32_t>(half + 127) << 23) * bit_cast<float>(static_cast<uint32_t>(n - half + 127) << 23);
+    }
+
+    // log(x) = e * ln(2) + log(m) with m in [sqrt(1/2), sqrt(2)).  Denormals are scaled up first.  Max error 0.83 ulp
+    // over all positive floats; 0 gives -inf, negative inputs and NaN give NaN
+    constexpr auto log(float x) -> float {
+        using namespace approx;
+        if (x != x || x < 0.f) return bit_cast<float>(NAN_BITS);
+        if (x == 0.f) return -bit_cast<float>(INFINITY_BITS);
+        if (x == bit_cast<float>(INFINITY_BITS)) return x;
+
+        auto const tiny = x < MIN_NORMAL;
+        auto const bits = bit_cast<uint32_t>(tiny ? x * 8388608.f : x);
+        auto e = static_cast<int32_t>(bits >> 23) - (tiny ? 149 : 126);
+        auto const m = bit_cast<float>((bits & 0x007fffffu) | 0x3f000000u);
+
+        auto const small = m < SQRT_HALF;
+        e = small ? e - 1 : e;
+        auto t = m - 1.f;
+        t = small ? t + m : t;
+
+        auto const z = t * t;
+        auto y = ((((((((LOG_0 * t + LOG_1) * t + LOG_2) * t + LOG_3) * t + LOG_4) * t + LOG_5) * t + LOG_6) * t + LOG_7) * t + LOG_8) * t * z;
+        auto const fe = static_cast<float>(e);
+        y = y + fe * LN2_LOW;
+        y = y - 0.5f * z;
+        return (t + y) + fe * LN2_HIGH;
+    }
+
+    // exp(y * log(x)) for x > 0.  The rounding error of the product is magnified by exp, so the error grows to at most
+    // 1 + 2 * |y * log(x)| ulp: 1.9 for |y * log(x)| <= 1, 17 at 10, more for results near the ends of the float range
+    constexpr auto pow(float x, float y) -> float { return exp(y * log(x)); }
+
+    // SIMD Kernels ////////////////////////////////////////////////////////////////////////////////////////////////////
+#if MATH_SSE2
+    namespace simd {
+        auto inline load(vector4 const& v) -> __m128 { return _mm_loadu_ps(&v.x); }
+
+        auto inline store(__m128 v) -> vector4 {
+            vector4 r;
+            _mm_storeu_ps(&r.x, v);
+            return r;
+        }
+
+        template<int I> auto inline splat(__m128 v) -> __m128 { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)); }
+
+        // Sum of all lanes in every lane
+        auto inline horizontal_add(__m128 v) -> __m128 {
+            v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+
+        auto inline dot(vector4 const& a, vector4 const& b) -> float {
+            return _mm_cvtss_f32(horizontal_add(_mm_mul_ps(load(a), load(b))));
+        }
+
+        auto inline normalize(vector4 const& v) -> vector4 {
+            auto const x = load(v);
+            return store(_mm_div_ps(x, _mm_sqrt_ps(horizontal_add(_mm_mul_ps(x, x)))));
+        }
+
+        auto inline transform(matrix4 const& m, __m128 v) -> __m128 {
+            auto r = _mm_mul_ps(load(m.x), splat<0>(v));
+            r = _mm_add_ps(r, _mm_mul_ps(load(m.y), splat<1>(v)));
+            r = _mm_add_ps(r, _mm_mul_ps(load(m.z), splat<2>(v)));
+            return _mm_add_ps(r, _mm_mul_ps(load(m.w), splat<3>(v)));
+        }
+
+        auto inline transform(matrix4 const& m, vector4 const& v) -> vector4 { return store(transform(m, load(v))); }
+
+        // With AVX two result columns are built per instruction
+        auto inline multiply(matrix4 const& a, matrix4 const& b) -> matrix4 {
+            matrix4 r;
+#if MATH_AVX
+            auto const twice = [](__m128 v) { return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1); };
+            auto const a0 = twice(load(a.x)), a1 = twice(load(a.y)), a2 = twice(load(a.z)), a3 = twice(load(a.w));
+            for (auto j = 0; j < 16; j += 8) {
+                auto const columns = _mm256_loadu_ps(&b.x.x + j);
+                auto c = _mm256_mul_ps(a0, _mm256_shuffle_ps(columns, columns, 0x00));
+                c = _mm256_add_ps(c, _mm256_mul_ps(a1, _mm256_shuffle_ps(columns, columns, 0x55)));
+                c = _mm256_add_ps(c, _mm256_mul_ps(a2, _mm256_shuffle_ps(columns, columns, 0xaa)));
+                c = _mm256_add_ps(c, _mm256_mul_ps(a3, _mm256_shuffle_ps(columns, columns, 0xff)));
+                _mm256_storeu_ps(&r.x.x + j, c);
+            }
+#else
+            for (auto j = 0; j < 16; j += 4) _mm_storeu_ps(&r.x.x + j, transform(a, _mm_loadu_ps(&b.x.x + j)));
+#endif
+            return r;
+        }
+
+        auto inline transpose(matrix4 const& m) -> matrix4 {
+            auto c0 = load(m.x), c1 = load(m.y), c2 = load(m.z), c3 = load(m.w);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            return {store(c0), store(c1), store(c2), store(c3)};
+        }
+
+        // Block inverse over the four 2x2 sub-matrices (Eric Zhang's formulation).  Each __m128 holds a 2x2 block;
+        // the algebra doesn't care whether blocks are read as rows or columns as long as it's consistent
+        auto inline mat2_multiply(__m128 a, __m128 b) -> __m128 {
+            return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        // adjugate(a) * b
+        auto inline mat2_adjugate_multiply(__m128 a, __m128 b) -> __m128 {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        // a * adjugate(b)
+        auto inline mat2_multiply_adjugate(__m128 a, __m128 b) -> __m128 {
+            return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        auto inline inverse(matrix4 const& m) -> matrix4 {
+            auto const c0 = load(m.x), c1 = load(m.y), c2 = load(m.z), c3 = load(m.w);
+            auto const a = _mm_movelh_ps(c0, c1);
+            auto const b = _mm_movehl_ps(c1, c0);
+            auto const c = _mm_movelh_ps(c2, c3);
+            auto const d = _mm_movehl_ps(c3, c2);
+
+            // (|A| |B| |C| |D|)
+            auto const determinants = _mm_sub_ps(
+                    _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+                    _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+            auto const det_a = splat<0>(determinants);
+            auto const det_b = splat<1>(determinants);
+            auto const det_c = splat<2>(determinants);
+            auto const det_d = splat<3>(determinants);
+
+            auto const d_c = mat2_adjugate_multiply(d, c);
+            auto const a_b = mat2_adjugate_multiply(a, b);
+            auto x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_multiply(b, d_c));
+            auto w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_multiply(c, a_b));
+            auto y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_multiply_adjugate(d, a_b));
+            auto z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_multiply_adjugate(a, d_c));
+
+            // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+            auto const trace = horizontal_add(_mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0))));
+            auto const det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), trace);
+            auto const scale = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+
+            x = _mm_mul_ps(x, scale);
+            y = _mm_mul_ps(y, scale);
+            z = _mm_mul_ps(z, scale);
+            w = _mm_mul_ps(w, scale);
+            return {store(_mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3))), store(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2))),
+                    store(_mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3))), store(_mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)))};
+        }
+    }
+#endif
+
+    // Transcendental Lanes ////////////////////////////////////////////////////////////////////////////////////////////
+    // 4 and 8 lane forms of the scalar transcendentals, operation for operation, with branches turned into selects
+#if MATH_SSE2
+    namespace simd {
+        // mask ? a : b, for masks of all ones or all zeros per lane
+        auto inline select(__m128 mask, __m128 a, __m128 b) -> __m128 { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        TARGET_AVX2 auto inline select(__m256 mask, __m256 a, __m256 b) -> __m256 { return _mm256_blendv_ps(b, a, mask); }
+
+        auto inline bits(uint32_t value) -> __m128 { return _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(value))); }
+        TARGET_AVX2 auto inline bits8(uint32_t value) -> __m256 { return _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int32_t>(value))); }
+
+        auto inline sincos(__m128 x, __m128& s, __m128& c) -> void {
+            using namespace approx;
+            auto const sign = _mm_and_ps(x, bits(SIGN_BIT));
+            auto const a = _mm_andnot_ps(bits(SIGN_BIT), x);
+
+            auto const q = _mm_min_ps(a, _mm_set1_ps(SINCOS_LIMIT));
+            auto const j = _mm_and_si128(_mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(q, _mm_set1_ps(FOUR_OVER_PI))), _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+            auto const y = _mm_cvtepi32_ps(j);
+            auto const r = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(a, _mm_mul_ps(y, _mm_set1_ps(PI_OVER_4_HIGH))), _mm_mul_ps(y, _mm_set1_ps(PI_OVER_4_MID))), _mm_mul_ps(y, _mm_set1_ps(PI_OVER_4_LOW)));
+            auto const r2 = _mm_mul_ps(r, r);
+
+            auto ps = _mm_add_ps(_mm_set1_ps(SIN_1), _mm_mul_ps(r2, _mm_set1_ps(SIN_2)));
+            ps = _mm_add_ps(_mm_set1_ps(SIN_0), _mm_mul_ps(r2, ps));
+            ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+            auto pc = _mm_add_ps(_mm_set1_ps(COS_1), _mm_mul_ps(r2, _mm_set1_ps(COS_2)));
+            pc = _mm_add_ps(_mm_set1_ps(COS_0), _mm_mul_ps(r2, pc));
+            pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), pc));
+
+            auto const swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+            auto const sine = select(swap, pc, ps);
+            auto const cosine = select(swap, ps, pc);
+            auto const sine_flip = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+            auto const cosine_flip = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+            s = _mm_xor_ps(_mm_xor_ps(sine, sign), sine_flip);
+            c = _mm_xor_ps(cosine, cosine_flip);
+        }
+
+        TARGET_AVX2 auto inline sincos(__m256 x, __m256& s, __m256& c) -> void {
+            using namespace approx;
+            auto const sign = _mm256_and_ps(x, bits8(SIGN_BIT));
+            auto const a = _mm256_andnot_ps(bits8(SIGN_BIT), x);
+
+            auto const q = _mm256_min_ps(a, _mm256_set1_ps(SINCOS_LIMIT));
+            auto const j = _mm256_and_si256(_mm256_add_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(q, _mm256_set1_ps(FOUR_OVER_PI))), _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+            auto const y = _mm256_cvtepi32_ps(j);
+            auto const r = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(a, _mm256_mul_ps(y, _mm256_set1_ps(PI_OVER_4_HIGH))), _mm256_mul_ps(y, _mm256_set1_ps(PI_OVER_4_MID))), _mm256_mul_ps(y, _mm256_set1_ps(PI_OVER_4_LOW)));
+            auto const r2 = _mm256_mul_ps(r, r);
+
+            auto ps = _mm256_add_ps(_mm256_set1_ps(SIN_1), _mm256_mul_ps(r2, _mm256_set1_ps(SIN_2)));
+            ps = _mm256_add_ps(_mm256_set1_ps(SIN_0), _mm256_mul_ps(r2, ps));
+            ps = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), ps));
+            auto pc = _mm256_add_ps(_mm256_set1_ps(COS_1), _mm256_mul_ps(r2, _mm256_set1_ps(COS_2)));
+            pc = _mm256_add_ps(_mm256_set1_ps(COS_0), _mm256_mul_ps(r2, pc));
+            pc = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_mul_ps(_mm256_mul_ps(r2, r2), pc));
+
+            auto const swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+            auto const sine = select(swap, pc, ps);
+            auto const cosine = select(swap, ps, pc);
+            auto const sine_flip = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+            auto const cosine_flip = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+            s = _mm256_xor_ps(_mm256_xor_ps(sine, sign), sine_flip);
+            c = _mm256_xor_ps(cosine, cosine_flip);
+        }
+
+        auto inline sin(__m128 x) -> __m128 { __m128 s, c; sincos(x, s, c); return s; }
+        auto inline cos(__m128 x) -> __m128 { __m128 s, c; sincos(x, s, c); return c; }
+        TARGET_AVX2 auto inline sin(__m256 x) -> __m256 { __m256 s, c; sincos(x, s, c); return s; }
+        TARGET_AVX2 auto inline cos(__m256 x) -> __m256 { __m256 s, c; sincos(x, s, c); return c; }
+
+        auto inline atan2(__m128 y, __m128 x) -> __m128 {
+            using namespace approx;
+            auto const ax = _mm_andnot_ps(bits(SIGN_BIT), x);
+            auto const ay = _mm_andnot_ps(bits(SIGN_BIT), y);
+            auto const high = _mm_max_ps(ay, ax), low = _mm_min_ps(ay, ax);
+            auto a = _mm_andnot_ps(_mm_cmpeq_ps(high, _mm_setzero_ps()), _mm_div_ps(low, high));
+
+            auto const one = _mm_set1_ps(1.f);
+            auto const reduce = _mm_cmpgt_ps(a, _mm_set1_ps(TAN_PI_OVER_8));
+            a = select(reduce, _mm_div_ps(_mm_sub_ps(a, one), _mm_add_ps(a, one)), a);
+            auto const z = _mm_mul_ps(a, a);
+            auto r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_0), z), _mm_set1_ps(ATAN_1));
+            r = _mm_add_ps(_mm_mul_ps(r, z), _mm_set1_ps(ATAN_2));
+            r = _mm_add_ps(_mm_mul_ps(r, z), _mm_set1_ps(ATAN_3));
+            r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, z), a), a);
+            r = _mm_add_ps(r, _mm_and_ps(reduce, _mm_set1_ps(PI * 0.25f)));
+
+            r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(PI * 0.5f), r), r);
+            r = select(_mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31)), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+            return _mm_or_ps(r, _mm_and_ps(y, bits(SIGN_BIT)));
+        }
+
+        TARGET_AVX2 auto inline atan2(__m256 y, __m256 x) -> __m256 {
+            using namespace approx;
+            auto const ax = _mm256_andnot_ps(bits8(SIGN_BIT), x);
+            auto const ay = _mm256_andnot_ps(bits8(SIGN_BIT), y);
+            auto const high = _mm256_max_ps(ay, ax), low = _mm256_min_ps(ay, ax);
+            auto a = _mm256_andnot_ps(_mm256_cmp_ps(high, _mm256_setzero_ps(), _CMP_EQ_OQ), _mm256_div_ps(low, high));
+
+            auto const one = _mm256_set1_ps(1.f);
+            auto const reduce = _mm256_cmp_ps(a, _mm256_set1_ps(TAN_PI_OVER_8), _CMP_GT_OQ);
+            a = select(reduce, _mm256_div_ps(_mm256_sub_ps(a, one), _mm256_add_ps(a, one)), a);
+            auto const z = _mm256_mul_ps(a, a);
+            auto r = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(ATAN_0), z), _mm256_set1_ps(ATAN_1));
+            r = _mm256_add_ps(_mm256_mul_ps(r, z), _mm256_set1_ps(ATAN_2));
+            r = _mm256_add_ps(_mm256_mul_ps(r, z), _mm256_set1_ps(ATAN_3));
+            r = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(r, z), a), a);
+            r = _mm256_add_ps(r, _mm256_and_ps(reduce, _mm256_set1_ps(PI * 0.25f)));
+
+            r = select(_mm256_cmp_ps(ay, ax, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(PI * 0.5f), r), r);
+            r = select(_mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(x), 31)), _mm256_sub_ps(_mm256_set1_ps(PI), r), r);
+            return _mm256_or_ps(r, _mm256_and_ps(y, bits8(SIGN_BIT)));
+        }
+
+        auto inline exp(__m128 x) -> __m128 {
+            using namespace approx;
+            auto const nan = _mm_cmpunord_ps(x, x);
+            auto const overflow = _mm_cmpgt_ps(x, _mm_set1_ps(EXP_HIGH));
+            auto const input = x;
+            x = _mm_max_ps(x, _mm_set1_ps(EXP_LOW));
+
+            auto const magic = _mm_set1_ps(ROUNDING_MAGIC);
+            auto const fn = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(LOG2_E)), magic), magic);
+            auto const r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(LN2_HIGH))), _mm_mul_ps(fn, _mm_set1_ps(LN2_LOW)));
+            auto const r2 = _mm_mul_ps(r, r);
+            auto p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(EXP_0), r), _mm_set1_ps(EXP_1));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_2));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_3));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_4));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_5));
+            p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, r2), r), _mm_set1_ps(1.f));
+
+            auto const n = _mm_cvttps_epi32(fn);
+            auto const half = _mm_srai_epi32(n, 1);
+            auto const bias = _mm_set1_epi32(127);
+            auto const scale_low = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(half, bias), 23));
+            auto const scale_high = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_sub_epi32(n, half), bias), 23));
+            auto const result = _mm_mul_ps(_mm_mul_ps(p, scale_low), scale_high);
+            return select(nan, input, select(overflow, bits(INFINITY_BITS), result));
+        }
+
+        TARGET_AVX2 auto inline exp(__m256 x) -> __m256 {
+            using namespace approx;
+            auto const nan = _mm256_cmp_ps(x, x, _CMP_UNORD_Q);
+            auto const overflow = _mm256_cmp_ps(x, _mm256_set1_ps(EXP_HIGH), _CMP_GT_OQ);
+            auto const input = x;
+            x = _mm256_max_ps(x, _mm256_set1_ps(EXP_LOW));
+
+            auto const magic = _mm256_set1_ps(ROUNDING_MAGIC);
+            auto const fn = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(LOG2_E)), magic), magic);
+            auto const r = _mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(fn, _mm256_set1_ps(LN2_HIGH))), _mm256_mul_ps(fn, _mm256_set1_ps(LN2_LOW)));
+            auto const r2 = _mm256_mul_ps(r, r);
+            auto p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(EXP_0), r), _mm256_set1_ps(EXP_1));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_2));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_3));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_4));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_5));
+            p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, r2), r), _mm256_set1_ps(1.f));
+
+            auto const n = _mm256_cvttps_epi32(fn);
+            auto const half = _mm256_srai_epi32(n, 1);
+            auto const bias = _mm256_set1_epi32(127);
+            auto const scale_low = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(half, bias), 23));
+            auto const scale_high = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_sub_epi32(n, half), bias), 23));
+            auto const result = _mm256_mul_ps(_mm256_mul_ps(p, scale_low), scale_high);
+            return select(nan, input, select(overflow, bits8(INFINITY_BITS), result));
+        }
+
+        auto inline log(__m128 x) -> __m128 {
+            using namespace approx;
+            auto const invalid = _mm_cmpnge_ps(x, _mm_setzero_ps());
+            auto const zero = _mm_cmpeq_ps(x, _mm_setzero_ps());
+            auto const infinite = _mm_cmpeq_ps(x, bits(INFINITY_BITS));
+
+            auto const tiny = _mm_cmplt_ps(x, _mm_set1_ps(MIN_NORMAL));
+            auto const scaled = _mm_castps_si128(select(tiny, _mm_mul_ps(x, _mm_set1_ps(8388608.f)), x));
+            auto e = _mm_sub_epi32(_mm_srli_epi32(scaled, 23), _mm_add_epi32(_mm_set1_epi32(126), _mm_and_si128(_mm_castps_si128(tiny), _mm_set1_epi32(23))));
+            auto const m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(scaled, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000)));
+
+            auto const small = _mm_cmplt_ps(m, _mm_set1_ps(SQRT_HALF));
+            e = _mm_add_epi32(e, _mm_castps_si128(small));
+            auto t = _mm_sub_ps(m, _mm_set1_ps(1.f));
+            t = select(small, _mm_add_ps(t, m), t);
+
+            auto const z = _mm_mul_ps(t, t);
+            auto y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LOG_0), t), _mm_set1_ps(LOG_1));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_2));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_3));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_4));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_5));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_6));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_7));
+            y = _mm_add_ps(_mm_mul_ps(y, t), _mm_set1_ps(LOG_8));
+            y = _mm_mul_ps(_mm_mul_ps(y, t), z);
+            auto const fe = _mm_cvtepi32_ps(e);
+            y = _mm_add_ps(y, _mm_mul_ps(fe, _mm_set1_ps(LN2_LOW)));
+            y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+            auto const result = _mm_add_ps(_mm_add_ps(t, y), _mm_mul_ps(fe, _mm_set1_ps(LN2_HIGH)));
+            return select(invalid, bits(NAN_BITS), select(zero, bits(INFINITY_BITS | SIGN_BIT), select(infinite, x, result)));
+        }
+
+        TARGET_AVX2 auto inline log(__m256 x) -> __m256 {
+            using namespace approx;
+            auto const invalid = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_NGE_UQ);
+            auto const zero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+            auto const infinite = _mm256_cmp_ps(x, bits8(INFINITY_BITS), _CMP_EQ_OQ);
+
+            auto const tiny = _mm256_cmp_ps(x, _mm256_set1_ps(MIN_NORMAL), _CMP_LT_OQ);
+            auto const scaled = _mm256_castps_si256(select(tiny, _mm256_mul_ps(x, _mm256_set1_ps(8388608.f)), x));
+            auto e = _mm256_sub_epi32(_mm256_srli_epi32(scaled, 23), _mm256_add_epi32(_mm256_set1_epi32(126), _mm256_and_si256(_mm256_castps_si256(tiny), _mm256_set1_epi32(23))));
+            auto const m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(scaled, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000)));
+
+            auto const small = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+            e = _mm256_add_epi32(e, _mm256_castps_si256(small));
+            auto t = _mm256_sub_ps(m, _mm256_set1_ps(1.f));
+            t = select(small, _mm256_add_ps(t, m), t);
+
+            auto const z = _mm256_mul_ps(t, t);
+            auto y = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(LOG_0), t), _mm256_set1_ps(LOG_1));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_2));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_3));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_4));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_5));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_6));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_7));
+            y = _mm256_add_ps(_mm256_mul_ps(y, t), _mm256_set1_ps(LOG_8));
+            y = _mm256_mul_ps(_mm256_mul_ps(y, t), z);
+            auto const fe = _mm256_cvtepi32_ps(e);
+            y = _mm256_add_ps(y, _mm256_mul_ps(fe, _mm256_set1_ps(LN2_LOW)));
+            y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+            auto const result = _mm256_add_ps(_mm256_add_ps(t, y), _mm256_mul_ps(fe, _mm256_set1_ps(LN2_HIGH)));
+            return select(invalid, bits8(NAN_BITS), select(zero, bits8(INFINITY_BITS | SIGN_BIT), select(infinite, x, result)));
+        }
+
+        auto inline pow(__m128 x, __m128 y) -> __m128 { return exp(_mm_mul_ps(y, log(x))); }
+        TARGET_AVX2 auto inline pow(__m256 x, __m256 y) -> __m256 { return exp(_mm256_mul_ps(y, log(x))); }
+    }
+#endif
+
+    // Vectors /////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename T, int N> constexpr auto component(vector<T,N>& v, int i) -> T& {
+        if constexpr (N > 3) if (i == 3) return v.w;
+        if constexpr (N > 2) if (i == 2) return v.z;
+        if constexpr (N > 1) if (i == 1) return v.y;
+        return v.x;
+    }
+
+    template<typename T, int N> constexpr auto component(vector<T,N> const& v, int i) -> T const& {
+        return component(const_cast<vector<T,N>&>(v), i);
+    }
+
+    template<typename T, int N, typename F> constexpr auto apply(vector<T,N> const& a, vector<T,N> const& b, F&& function) -> vector<T,N> {
+        vector<T,N> r{};
+        for (auto i = 0; i < N; ++i) component(r, i) = function(component(a, i), component(b, i));
+        return r;
+    }
+
+    template<typename T, int N> constexpr auto operator+(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_add_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return l + r; });
+    }
+
+    template<typename T, int N> constexpr auto operator-(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_sub_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return l - r; });
+    }
+
+    template<typename T, int N> constexpr auto operator*(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_mul_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return l * r; });
+    }
+
+    template<typename T, int N> constexpr auto operator/(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_div_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return l / r; });
+    }
+
+    template<typename T, int N> constexpr auto operator*(vector<T,N> const& v, T s) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_mul_ps(simd::load(v), _mm_set1_ps(s))));
+        return apply(v, v, [s](T l, T) { return l * s; });
+    }
+
+    template<typename T, int N> constexpr auto operator*(T s, vector<T,N> const& v) -> vector<T,N> { return v * s; }
+
+    template<typename T, int N> constexpr auto operator/(vector<T,N> const& v, T s) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_div_ps(simd::load(v), _mm_set1_ps(s))));
+        return apply(v, v, [s](T l, T) { return l / s; });
+    }
+
+    template<typename T, int N> constexpr auto operator-(vector<T,N> const& v) -> vector<T,N> { return vector<T,N>{} - v; }
+
+    template<typename T, int N> constexpr auto operator+=(vector<T,N>& a, vector<T,N> const& b) -> vector<T,N>& { return a = a + b; }
+    template<typename T, int N> constexpr auto operator-=(vector<T,N>& a, vector<T,N> const& b) -> vector<T,N>& { return a = a - b; }
+    template<typename T, int N> constexpr auto operator*=(vector<T,N>& a, vector<T,N> const& b) -> vector<T,N>& { return a = a * b; }
+    template<typename T, int N> constexpr auto operator/=(vector<T,N>& a, vector<T,N> const& b) -> vector<T,N>& { return a = a / b; }
+    template<typename T, int N> constexpr auto operator*=(vector<T,N>& v, T s) -> vector<T,N>& { return v = v * s; }
+    template<typename T, int N> constexpr auto operator/=(vector<T,N>& v, T s) -> vector<T,N>& { return v = v / s; }
+
+    template<typename T, int N> constexpr auto operator==(vector<T,N> const& a, vector<T,N> const& b) -> bool {
+        for (auto i = 0; i < N; ++i) if (component(a, i) != component(b, i)) return false;
+        return true;
+    }
+
+    template<typename T, int N> constexpr auto operator!=(vector<T,N> const& a, vector<T,N> const& b) -> bool { return !(a == b); }
+
+    template<typename T, int N> constexpr auto min(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_min_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return min(l, r); });
+    }
+
+    template<typename T, int N> constexpr auto max(vector<T,N> const& a, vector<T,N> const& b) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::store(_mm_max_ps(simd::load(a), simd::load(b))));
+        return apply(a, b, [](T l, T r) { return max(l, r); });
+    }
+
+    template<typename T, int N> constexpr auto lerp(vector<T,N> const& a, vector<T,N> const& b, T t) -> vector<T,N> { return a + (b - a) * t; }
+
+    template<typename T, int N> constexpr auto dot(vector<T,N> const& a, vector<T,N> const& b) -> T {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::dot(a, b));
+        auto sum = T{};
+        for (auto i = 0; i < N; ++i) sum += component(a, i) * component(b, i);
+        return sum;
+    }
+
+    template<typename T> constexpr auto cross(vector<T,3> const& a, vector<T,3> const& b) -> vector<T,3> {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    template<typename T, int N> constexpr auto length_squared(vector<T,N> const& v) -> T { return dot(v, v); }
+    template<typename T, int N> constexpr auto length(vector<T,N> const& v) -> T { return sqrt(dot(v, v)); }
+
+    // Undefined for the zero vector
+    template<typename T, int N> constexpr auto normalize(vector<T,N> const& v) -> vector<T,N> {
+        MATH_SIMD_RETURN((is_vector4<T, N>), simd::normalize(v));
+        return v / length(v);
+    }
+
+    // Matrices ////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Matrices are column major: matrix<T,M,N> has N columns of M rows, and m * v treats v as a column vector
+    template<typename T, int M, int N> constexpr auto column(matrix<T,M,N>& m, int j) -> vector<T,M>& {
+        if constexpr (N > 3) if (j == 3) return m.w;
+        if constexpr (N > 2) if (j == 2) return m.z;
+        if constexpr (N > 1) if (j == 1) return m.y;
+        return m.x;
+    }
+
+    template<typename T, int M, int N> constexpr auto column(matrix<T,M,N> const& m, int j) -> vector<T,M> const& {
+        return column(const_cast<matrix<T,M,N>&>(m), j);
+    }
+
+    template<typename T, int M, int N> constexpr auto at(matrix<T,M,N> const& m, int row, int col) -> T { return component(column(m, col), row); }
+
+    template<typename Matrix> constexpr auto identity() -> Matrix {
+        auto constexpr n = static_cast<int>(sizeof(Matrix) / sizeof(Matrix{}.x));
+        auto m = Matrix{};
+        for (auto i = 0; i < n; ++i) component(column(m, i), i) = 1;
+        return m;
+    }
+
+    template<typename T, int M, int N> constexpr auto operator*(matrix<T,M,N> const& m, vector<T,N> const& v) -> vector<T,M> {
+        MATH_SIMD_RETURN((is_matrix4<T, M, N>), simd::transform(m, v));
+        auto r = vector<T,M>{};
+        for (auto j = 0; j < N; ++j) r += column(m, j) * component(v, j);
+        return r;
+    }
+
+    template<typename T, int M, int K, int N> constexpr auto operator*(matrix<T,M,K> const& a, matrix<T,K,N> const& b) -> matrix<T,M,N> {
+        MATH_SIMD_RETURN((is_matrix4<T, M, N> && K == 4), simd::multiply(a, b));
+        auto r = matrix<T,M,N>{};
+        for (auto j = 0; j < N; ++j) column(r, j) = a * column(b, j);
+        return r;
+    }
+
+    template<typename T, int M, int N> constexpr auto operator*=(matrix<T,M,N>& a, matrix<T,N,N> const& b) -> matrix<T,M,N>& { return a = a * b; }
+
+    template<typename T, int M, int N> constexpr auto operator==(matrix<T,M,N> const& a, matrix<T,M,N> const& b) -> bool {
+        for (auto j = 0; j < N; ++j) if (column(a, j) != column(b, j)) return false;
+        return true;
+    }
+
+    template<typename T, int M, int N> constexpr auto operator!=(matrix<T,M,N> const& a, matrix<T,M,N> const& b) -> bool { return !(a == b); }
+
+    template<typename T, int M, int N> constexpr auto transpose(matrix<T,M,N> const& m) -> matrix<T,N,M> {
+        MATH_SIMD_RETURN((is_matrix4<T, M, N>), simd::transpose(m));
+        auto r = matrix<T,N,M>{};
+        for (auto j = 0; j < N; ++j)
+            for (auto i = 0; i < M; ++i) component(column(r, i), j) = at(m, i, j);
+        return r;
+    }
+
+    template<typename T, int N> constexpr auto determinant(matrix<T,N,N> const& m) -> T {
+        static_assert(N >= 2 && N <= 4, "determinant is implemented for 2x2 to 4x4 matrices");
+        if constexpr (N == 2) {
+            return m.x.x * m.y.y - m.y.x * m.x.y;
+        } else if constexpr (N == 3) {
+            return dot(m.x, cross(m.y, m.z));
+        } else {
+            auto const s0 = m.x.x * m.y.y - m.y.x * m.x.y, s1 = m.x.x * m.y.z - m.y.x * m.x.z, s2 = m.x.x * m.y.w - m.y.x * m.x.w;
+            auto const s3 = m.x.y * m.y.z - m.y.y * m.x.z, s4 = m.x.y * m.y.w - m.y.y * m.x.w, s5 = m.x.z * m.y.w - m.y.z * m.x.w;
+            auto const c5 = m.z.z * m.w.w - m.w.z * m.z.w, c4 = m.z.y * m.w.w - m.w.y * m.z.w, c3 = m.z.y * m.w.z - m.w.y * m.z.z;
+            auto const c2 = m.z.x * m.w.w - m.w.x * m.z.w, c1 = m.z.x * m.w.z - m.w.x * m.z.z, c0 = m.z.x * m.w.y - m.w.x * m.z.y;
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+    }
+
+    // Undefined for singular matrices
+    template<typename T, int N> constexpr auto inverse(matrix<T,N,N> const& m) -> matrix<T,N,N> {
+        static_assert(N >= 2 && N <= 4, "inverse is implemented for 2x2 to 4x4 matrices");
+        MATH_SIMD_RETURN((is_matrix4<T, N, N>), simd::inverse(m));
+        if constexpr (N == 2) {
+            auto const s = T{1} / determinant(m);
+            return {{m.y.y * s, -m.x.y * s}, {-m.y.x * s, m.x.x * s}};
+        } else if constexpr (N == 3) {
+            // The rows of the inverse are the cross products of pairs of columns
+            auto const r0 = cross(m.y, m.z), r1 = cross(m.z, m.x), r2 = cross(m.x, m.y);
+            auto const s = T{1} / dot(m.x, r0);
+            return transpose(matrix<T,3,3>{r0 * s, r1 * s, r2 * s});
+        } else {
+            // Laplace expansion over the 2x2 minors of the first and last two columns
+            auto const s0 = m.x.x * m.y.y - m.y.x * m.x.y, s1 = m.x.x * m.y.z - m.y.x * m.x.z, s2 = m.x.x * m.y.w - m.y.x * m.x.w;
+            auto const s3 = m.x.y * m.y.z - m.y.y * m.x.z, s4 = m.x.y * m.y.w - m.y.y * m.x.w, s5 = m.x.z * m.y.w - m.y.z * m.x.w;
+            auto const c5 = m.z.z * m.w.w - m.w.z * m.z.w, c4 = m.z.y * m.w.w - m.w.y * m.z.w, c3 = m.z.y * m.w.z - m.w.y * m.z.z;
+            auto const c2 = m.z.x * m.w.w - m.w.x * m.z.w, c1 = m.z.x * m.w.z - m.w.x * m.z.z, c0 = m.z.x * m.w.y - m.w.x * m.z.y;
+            auto const s = T{1} / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+            return {{( m.y.y * c5 - m.y.z * c4 + m.y.w * c3) * s, (-m.x.y * c5 + m.x.z * c4 - m.x.w * c3) * s,
+                     ( m.w.y * s5 - m.w.z * s4 + m.w.w * s3) * s, (-m.z.y * s5 + m.z.z * s4 - m.z.w * s3) * s},
+                    {(-m.y.x * c5 + m.y.z * c2 - m.y.w * c1) * s, ( m.x.x * c5 - m.x.z * c2 + m.x.w * c1) * s,
+                     (-m.w.x * s5 + m.w.z * s2 - m.w.w * s1) * s, ( m.z.x * s5 - m.z.z * s2 + m.z.w * s1) * s},
+                    {( m.y.x * c4 - m.y.y * c2 + m.y.w * c0) * s, (-m.x.x * c4 + m.x.y * c2 - m.x.w * c0) * s,
+                     ( m.w.x * s4 - m.w.y * s2 + m.w.w * s0) * s, (-m.z.x * s4 + m.z.y * s2 - m.z.w * s0) * s},
+                    {(-m.y.x * c3 + m.y.y * c1 - m.y.z * c0) * s, ( m.x.x * c3 - m.x.y * c1 + m.x.z * c0) * s,
+                     (-m.w.x * s3 + m.w.y * s1 - m.w.z * s0) * s, ( m.z.x * s3 - m.z.y * s1 + m.z.z * s0) * s}};
+        }
+    }
+
+    constexpr auto translation(vector3 const& t) -> matrix4 {
+        return {{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}, {t.x, t.y, t.z, 1.f}};
+    }
+
+    constexpr auto scaling(vector3 const& s) -> matrix4 {
+        return {{s.x, 0.f, 0.f, 0.f}, {0.f, s.y, 0.f, 0.f}, {0.f, 0.f, s.z, 0.f}, {0.f, 0.f, 0.f, 1.f}};
+    }
+
+    // Quaternions /////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Unit quaternions represent rotations.  (x, y, z) is the vector part, w the scalar part
+    template<typename T> constexpr auto operator*(quaternion_t<T> const& a, quaternion_t<T> const& b) -> quaternion_t<T> {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+
+    template<typename T> constexpr auto dot(quaternion_t<T> const& a, quaternion_t<T> const& b) -> T {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    // The inverse of a unit quaternion
+    template<typename T> constexpr auto conjugate(quaternion_t<T> const& q) -> quaternion_t<T> { return {-q.x, -q.y, -q.z, q.w}; }
+
+    template<typename T> constexpr auto normalize(quaternion_t<T> const& q) -> quaternion_t<T> {
+        auto const s = T{1} / sqrt(dot(q, q));
+        return {q.x * s, q.y * s, q.z * s, q.w * s};
+    }
+
+    // Rotation of angle radians around a unit axis
+    constexpr auto axis_angle(vector3 const& axis, float angle) -> quaternion {
+        float s{}, c{};
+        sincos(angle * 0.5f, s, c);
+        return {axis.x * s, axis.y * s, axis.z * s, c};
+    }
+
+    template<typename T> constexpr auto rotate(quaternion_t<T> const& q, vector<T,3> const& v) -> vector<T,3> {
+        auto const u = vector<T,3>{q.x, q.y, q.z};
+        auto const t = cross(u, v) * T{2};
+        return v + t * q.w + cross(u, t);
+    }
+
+    // Normalized linear interpolation along the shorter arc.  Not constant speed like slerp, but needs no
+    // trigonometry and is close enough for blending nearby orientations
+    template<typename T> constexpr auto nlerp(quaternion_t<T> const& a, quaternion_t<T> const& b, T t) -> quaternion_t<T> {
+        auto const u = T{1} - t;
+        auto const v = dot(a, b) < T{} ? -t : t;
+        return normalize(quaternion_t<T>{a.x * u + b.x * v, a.y * u + b.y * v, a.z * u + b.z * v, a.w * u + b.w * v});
+    }
+
+    constexpr auto rotation(quaternion const& q) -> matrix4 {
+        auto const xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        auto const xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        auto const wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        return {{1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f},
+                {2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f},
+                {2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f},
+                {0.f, 0.f, 0.f, 1.f}};
+    }
+}
+
+#undef MATH_SIMD_RETURN
+
+#endif // ENGINE_CORE_MATH_H
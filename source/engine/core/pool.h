@@ -0,0 +1,135 @@
+#ifndef ENGINE_CORE_POOL_H
+#define ENGINE_CORE_POOL_H
+
+#include <engine/core/types.h>
+#include <engine/core/handle.h>
+
+namespace xc {
+    // Fixed capacity object pool.  Objects never move, so pointers stay valid until the object is destroyed, and
+    // handles detect use after destroy through the slot generation.  Live objects are also tracked in a packed index
+    // list, so iteration only visits live slots.  Tag accounts for the bookkeeping arrays and, by default, the objects.
+    // No destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged, typename Allocator = default_allocator<T, Tag>>
+    class pool {
+    public:
+        auto initialize(uint32_t capacity) -> bool {
+            if (capacity == 0 || capacity > handle<T>::INDEX_MASK + 1u) return false;
+
+            _objects = _allocator.allocate(capacity);
+            _slots = static_cast<slot*>(xc::allocate(capacity * sizeof(slot), Tag));
+            _dense = static_cast<uint32_t*>(xc::allocate(capacity * sizeof(uint32_t), Tag));
+            if (!_objects || !_slots || !_dense) {
+                release();
+                return false;
+            }
+
+            // Thread the free list through the slots in index order
+            for (auto i = 0u; i < capacity; ++i) _slots[i] = {1u, i + 1u};
+            _free = 0u;
+            _size = 0u;
+            _capacity = capacity;
+            return true;
+        }
+
+        auto release() -> void {
+            clear();
+            _allocator.deallocate(_objects);
+            xc::deallocate(_slots, Tag);
+            xc::deallocate(_dense, Tag);
+            _objects = nullptr;
+            _slots = nullptr;
+            _dense = nullptr;
+            _capacity = 0u;
+        }
+
+        template<typename... Args> auto create(Args&&... args) -> handle<T> {
+            if (_free >= _capacity) return {};
+
+            auto const index = _free;
+            auto& s = _slots[index];
+            _free = s.link;
+
+            _allocator.construct(_objects + index, move(args)...);
+            s.link = _size;
+            _dense[_size++] = index;
+            return handle<T>::make(index, s.generation);
+        }
+
+        auto destroy(handle<T> h) -> bool {
+            if (!contains(h)) return false;
+
+            auto const index = h.index();
+            auto& s = _slots[index];
+            _allocator.destroy(_objects + index);
+
+            // Swap the last live index into the hole
+            auto const last = _dense[--_size];
+            _dense[s.link] = last;
+            _slots[last].link = s.link;
+
+            s.generation = next_generation<T>(s.generation);
+            s.link = _free;
+            _free = index;
+            return true;
+        }
+
+        auto clear() -> void {
+            while (_size > 0) destroy(handle<T>::make(_dense[_size - 1], _slots[_dense[_size - 1]].generation));
+        }
+
+        [[nodiscard]] auto contains(handle<T> h) const -> bool {
+            auto const index = h.index();
+            return index < _capacity && _slots[index].generation == h.generation() && is_live(index);
+        }
+
+        auto get(handle<T> h) -> T* { return contains(h) ? _objects + h.index() : nullptr; }
+        auto get(handle<T> h) const -> T const* { return contains(h) ? _objects + h.index() : nullptr; }
+
+        // Handle for the i-th live object, in iteration order
+        [[nodiscard]] auto handle_at(uint32_t i) const -> handle<T> { return handle<T>::make(_dense[i], _slots[_dense[i]].generation); }
+
+        [[nodiscard]] auto size() const -> uint32_t { return _size; }
+        [[nodiscard]] auto capacity() const -> uint32_t { return _capacity; }
+
+        template<typename U> class iterator_t {
+        public:
+            iterator_t(U* objects, uint32_t const* index) : _objects{objects}, _index{index} {}
+
+            auto operator*() const -> U& { return _objects[*_index]; }
+            auto operator->() const -> U* { return _objects + *_index; }
+            auto operator++() -> iterator_t& { ++_index; return *this; }
+            auto operator!=(iterator_t const& other) const -> bool { return _index != other._index; }
+
+        private:
+            U* _objects;
+            uint32_t const* _index;
+        };
+
+        auto begin() -> iterator_t<T> { return {_objects, _dense}; }
+        auto end() -> iterator_t<T> { return {_objects, _dense + _size}; }
+        auto begin() const -> iterator_t<T const> { return {_objects, _dense}; }
+        auto end() const -> iterator_t<T const> { return {_objects, _dense + _size}; }
+
+    private:
+        // link is the next free slot while free, and the position in _dense while live
+        struct slot {
+            uint32_t generation;
+            uint32_t link;
+        };
+
+        T* _objects = nullptr;
+        slot* _slots = nullptr;
+        uint32_t* _dense = nullptr;
+        uint32_t _free = 0u;
+        uint32_t _size = 0u;
+        uint32_t _capacity = 0u;
+        Allocator _allocator;
+
+        auto is_live(uint32_t index) const -> bool {
+            auto const position = _slots[index].link;
+            return position < _size && _dense[position] == index;
+        }
+    };
+}
+
+#endif // ENGINE_CORE_POOL_H
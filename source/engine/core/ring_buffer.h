@@ -0,0 +1,365 @@
+#ifndef ENGINE_CORE_RING_BUFFER_H
+#define ENGINE_CORE_RING_BUFFER_H
+
+#include <engine/core/types.h>
+
+namespace xc {
+    auto static constexpr CACHE_LINE_SIZE = size_t{64};
+
+    // Bounded queue for exactly one producer thread and one consumer thread.  Each side owns its index on its own cache
+    // line and keeps a private copy of the other side's index, so it only touches the shared line when the copy says
+    // the ring looks full (or empty).  Capacity is rounded up to a power of two.
+    //
+    // Values are copied in and out bytewise, so T must be trivially copyable.  No destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged> class spsc_ring_buffer {
+        static_assert(__is_trivially_copyable(T), "ring buffer values must be trivially copyable");
+
+    public:
+        using value_type = T;
+
+        auto initialize(uint32_t capacity) -> bool {
+            if (capacity == 0 || capacity > (1u << 31)) return false;
+            auto size = size_t{1};
+            while (size < capacity) size <<= 1;
+
+            _data = static_cast<T*>(xc::allocate(size * sizeof(T), Tag));
+            if (!_data) return false;
+            _mask = size - 1;
+            _tail.store(0, std::memory_order_relaxed);
+            _head.store(0, std::memory_order_relaxed);
+            _cached_head = 0;
+            _cached_tail = 0;
+            return true;
+        }
+
+        auto release() -> void {
+            xc::deallocate(_data, Tag);
+            _data = nullptr;
+            _mask = 0;
+        }
+
+        // Producer side
+        auto push(T const& value) -> bool {
+            auto const tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _cached_head > _mask) {
+                _cached_head = _head.load(std::memory_order_acquire);
+                if (tail - _cached_head > _mask) return false;
+            }
+            _data[tail & _mask] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Pushes as many of the count values as fit and publishes them together.  Returns how many were pushed
+        auto push_batch(T const* values, size_t count) -> size_t {
+            auto const tail = _tail.load(std::memory_order_relaxed);
+            auto space = _mask + 1 - (tail - _cached_head);
+            if (space < count) {
+                _cached_head = _head.load(std::memory_order_acquire);
+                space = _mask + 1 - (tail - _cached_head);
+            }
+            if (count > space) count = space;
+            if (count == 0) return 0;
+
+            copy_in(tail, values, count);
+            _tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // Consumer side
+        auto pop(T& value) -> bool {
+            auto const head = _head.load(std::memory_order_relaxed);
+            if (head == _cached_tail) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                if (head == _cached_tail) return false;
+            }
+            value = _data[head & _mask];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Pops up to count values.  Returns how many were popped
+        auto pop_batch(T* values, size_t count) -> size_t {
+            auto const head = _head.load(std::memory_order_relaxed);
+            auto available = _cached_tail - head;
+            if (available < count) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                available = _cached_tail - head;
+            }
+            if (count > available) count = available;
+            if (count == 0) return 0;
+
+            copy_out(head, values, count);
+            _head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        // Only a snapshot while the other side is running
+        [[nodiscard]] auto size() const -> size_t {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+        [[nodiscard]] auto capacity() const -> size_t { return _data ? _mask + 1 : 0; }
+
+    private:
+        // Producer line
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail = 0u;
+        size_t _cached_head = 0u;
+
+        // Consumer line
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head = 0u;
+        size_t _cached_tail = 0u;
+
+        // Read only after initialize()
+        alignas(CACHE_LINE_SIZE) T* _data = nullptr;
+        size_t _mask = 0u;
+
+        // The range may wrap past the end of the buffer, so it's copied in up to two pieces
+        auto copy_in(size_t position, T const* values, size_t count) -> void {
+            auto const start = position & _mask;
+            auto const first = count < _mask + 1 - start ? count : _mask + 1 - start;
+            memcpy(_data + start, values, first * sizeof(T));
+            memcpy(_data, values + first, (count - first) * sizeof(T));
+        }
+
+        auto copy_out(size_t position, T* values, size_t count) const -> void {
+            auto const start = position & _mask;
+            auto const first = count < _mask + 1 - start ? count : _mask + 1 - start;
+            memcpy(values, _data + start, first * sizeof(T));
+            memcpy(values + first, _data, (count - first) * sizeof(T));
+        }
+    };
+
+    // Bounded queue for any number of producers and consumers (Vyukov's design).  Every cell carries a sequence number
+    // that says which lap of the ring it's ready for, so a thread claims a position with one compare-exchange on the
+    // shared index and then fills or drains its cell without further contention.  Batches claim a run of consecutive
+    // ready cells with a single compare-exchange.  Capacity is rounded up to a power of two.
+    //
+    // Values are copied in and out bytewise, so T must be trivially copyable.  No destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged> class mpmc_ring_buffer {
+        static_assert(__is_trivially_copyable(T), "ring buffer values must be trivially copyable");
+
+    public:
+        using value_type = T;
+
+        auto initialize(uint32_t capacity) -> bool {
+            if (capacity == 0 || capacity > (1u << 31)) return false;
+            auto size = size_t{1};
+            while (size < capacity) size <<= 1;
+
+            _cells = static_cast<cell*>(xc::allocate(size * sizeof(cell), Tag));
+            if (!_cells) return false;
+            for (size_t i = 0; i < size; ++i) _cells[i].sequence.store(i, std::memory_order_relaxed);
+            _mask = size - 1;
+            _tail.store(0, std::memory_order_relaxed);
+            _head.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        auto release() -> void {
+            xc::deallocate(_cells, Tag);
+            _cells = nullptr;
+            _mask = 0;
+        }
+
+        auto push(T const& value) -> bool {
+            auto position = _tail.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& c = _cells[position & _mask];
+                auto const sequence = c.sequence.load(std::memory_order_acquire);
+                auto const lag = static_cast<intptr_t>(sequence - position);
+                if (lag == 0) {
+                    if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        c.value = value;
+                        c.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false;
+                } else {
+                    position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Pushes as many of the count values as there are free cells in a row.  Returns how many were pushed
+        auto push_batch(T const* values, size_t count) -> size_t {
+            auto position = _tail.load(std::memory_order_relaxed);
+            for (;;) {
+                auto ready = size_t{};
+                while (ready < count && ready <= _mask &&
+                       _cells[(position + ready) & _mask].sequence.load(std::memory_order_acquire) == position + ready)
+                    ++ready;
+                if (ready == 0) {
+                    auto const sequence = _cells[position & _mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<intptr_t>(sequence - position) < 0) return 0;
+                    position = _tail.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (_tail.compare_exchange_weak(position, position + ready, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < ready; ++i) {
+                        auto& c = _cells[(position + i) & _mask];
+                        c.value = values[i];
+                        c.sequence.store(position + i + 1, std::memory_order_release);
+                    }
+                    return ready;
+                }
+            }
+        }
+
+        auto pop(T& value) -> bool {
+            auto position = _head.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& c = _cells[position & _mask];
+                auto const sequence = c.sequence.load(std::memory_order_acquire);
+                auto const lag = static_cast<intptr_t>(sequence - (position + 1));
+                if (lag == 0) {
+                    if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        value = c.value;
+                        c.sequence.store(position + _mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false;
+                } else {
+                    position = _head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Pops up to count values from a run of filled cells.  Returns how many were popped
+        auto pop_batch(T* values, size_t count) -> size_t {
+            auto position = _head.load(std::memory_order_relaxed);
+            for (;;) {
+                auto ready = size_t{};
+                while (ready < count && ready <= _mask &&
+                       _cells[(position + ready) & _mask].sequence.load(std::memory_order_acquire) == position + ready + 1)
+                    ++ready;
+                if (ready == 0) {
+                    auto const sequence = _cells[position & _mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<intptr_t>(sequence - (position + 1)) < 0) return 0;
+                    position = _head.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (_head.compare_exchange_weak(position, position + ready, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < ready; ++i) {
+                        auto& c = _cells[(position + i) & _mask];
+                        values[i] = c.value;
+                        c.sequence.store(position + i + _mask + 1, std::memory_order_release);
+                    }
+                    return ready;
+                }
+            }
+        }
+
+        // Only a snapshot while other threads are running
+        [[nodiscard]] auto size() const -> size_t {
+            auto const tail = _tail.load(std::memory_order_acquire);
+            auto const head = _head.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        [[nodiscard]] auto capacity() const -> size_t { return _cells ? _mask + 1 : 0; }
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail = 0u;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head = 0u;
+        alignas(CACHE_LINE_SIZE) cell* _cells = nullptr;
+        size_t _mask = 0u;
+    };
+
+    // Wraps either ring so that push() sleeps while it's full and pop() sleeps while it's empty.  Sleepers park on a
+    // counter word that the other side bumps after every successful operation; the counter is only followed by a
+    // wake call when someone is registered as waiting, so the uncontended path stays free of system calls.
+    // try_push() and try_pop() never sleep.  No destructor, call release() manually
+    template<typename Ring> class blocking_ring_buffer {
+    public:
+        using value_type = typename Ring::value_type;
+
+        auto initialize(uint32_t capacity) -> bool { return _ring.initialize(capacity); }
+        auto release() -> void { _ring.release(); }
+
+        auto try_push(value_type const& value) -> bool {
+            if (!_ring.push(value)) return false;
+            notify(_pushes, _pop_waiters);
+            return true;
+        }
+
+        auto try_pop(value_type& value) -> bool {
+            if (!_ring.pop(value)) return false;
+            notify(_pops, _push_waiters);
+            return true;
+        }
+
+        auto push(value_type const& value) -> void {
+            wait_until(_pops, _push_waiters, [&] { return _ring.push(value); });
+            notify(_pushes, _pop_waiters);
+        }
+
+        auto pop(value_type& value) -> void {
+            wait_until(_pushes, _pop_waiters, [&] { return _ring.pop(value); });
+            notify(_pops, _push_waiters);
+        }
+
+        // Returns once all count values are in the ring
+        auto push_batch(value_type const* values, size_t count) -> void {
+            while (count > 0) {
+                auto pushed = size_t{};
+                wait_until(_pops, _push_waiters, [&] { return (pushed = _ring.push_batch(values, count)) != 0; });
+                notify(_pushes, _pop_waiters);
+                values += pushed;
+                count -= pushed;
+            }
+        }
+
+        // Waits for at least one value, then takes up to count.  Returns how many were popped
+        auto pop_batch(value_type* values, size_t count) -> size_t {
+            if (count == 0) return 0;
+            auto popped = size_t{};
+            wait_until(_pushes, _pop_waiters, [&] { return (popped = _ring.pop_batch(values, count)) != 0; });
+            notify(_pops, _push_waiters);
+            return popped;
+        }
+
+        [[nodiscard]] auto size() const -> size_t { return _ring.size(); }
+        [[nodiscard]] auto capacity() const -> size_t { return _ring.capacity(); }
+
+    private:
+        Ring _ring;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> _pushes = 0u;
+        std::atomic<uint32_t> _pop_waiters = 0u;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> _pops = 0u;
+        std::atomic<uint32_t> _push_waiters = 0u;
+
+        // Registering as a waiter and re-checking the ring pairs with the fence in notify(): either the other side sees
+        // the waiter and wakes it, or the re-check sees the other side's update
+        template<typename F> auto static wait_until(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiters, F&& attempt) -> void {
+            if (attempt()) return;
+            for (;;) {
+                auto const seen = counter.load(std::memory_order_acquire);
+                waiters.fetch_add(1u, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (attempt()) {
+                    waiters.fetch_sub(1u, std::memory_order_relaxed);
+                    return;
+                }
+                wait_on_address(counter, seen);
+                waiters.fetch_sub(1u, std::memory_order_relaxed);
+                if (attempt()) return;
+            }
+        }
+
+        auto static notify(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiters) -> void {
+            counter.fetch_add(1u, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed)) wake_on_address(counter, ~0u);
+        }
+    };
+}
+
+#endif // ENGINE_CORE_RING_BUFFER_H
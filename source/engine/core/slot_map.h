@@ -0,0 +1,269 @@
+#ifndef ENGINE_CORE_SLOT_MAP_H
+#define ENGINE_CORE_SLOT_MAP_H
+
+#include <engine/core/types.h>
+#include <engine/core/handle.h>
+
+namespace xc {
+    // Growable map from generational handles to values packed in one dense array.  Removal moves the last value into
+    // the hole, so iteration is a linear walk over live values, while lookups go through the slot the handle names.
+    // Unlike pool, values move on removal and growth; hold handles, not pointers.  Tag accounts for the bookkeeping
+    // arrays and, by default, the values.  No destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged, typename Allocator = default_allocator<T, Tag>>
+    class slot_map {
+    public:
+        template<typename... Args> auto insert(Args&&... args) -> handle<T> {
+            if (_free == NONE) {
+                if (_slot_count > handle<T>::INDEX_MASK) return {};
+                if (_slot_count == _slot_capacity && !grow_slots()) return {};
+                _slots[_slot_count] = {1u, NONE};
+                _free = _slot_count++;
+            }
+            if (_size == _capacity && !reserve(_capacity == 0 ? 16u : _capacity * 2u)) return {};
+
+            auto const index = _free;
+            auto& s = _slots[index];
+            _free = s.link;
+
+            _allocator.construct(_values + _size, move(args)...);
+            _owners[_size] = index;
+            s.link = _size++;
+            return handle<T>::make(index, s.generation);
+        }
+
+        // Swap and pop: the last value fills the hole and its slot is repointed
+        auto remove(handle<T> h) -> bool {
+            if (!contains(h)) return false;
+
+            auto const index = h.index();
+            auto& s = _slots[index];
+            auto const last = --_size;
+            if (s.link != last) {
+                _values[s.link] = move(_values[last]);
+                _owners[s.link] = _owners[last];
+                _slots[_owners[last]].link = s.link;
+            }
+            _allocator.destroy(_values + last);
+
+            s.generation = next_generation<T>(s.generation);
+            s.link = _free;
+            _free = index;
+            return true;
+        }
+
+        auto clear() -> void {
+            while (_size > 0) remove(handle_at(_size - 1));
+        }
+
+        auto release() -> void {
+            clear();
+            _allocator.deallocate(_values);
+            xc::deallocate(_owners, Tag);
+            xc::deallocate(_slots, Tag);
+            _values = nullptr;
+            _owners = nullptr;
+            _slots = nullptr;
+            _capacity = 0u;
+            _slot_count = 0u;
+            _slot_capacity = 0u;
+            _free = NONE;
+        }
+
+        auto reserve(uint32_t capacity) -> bool {
+            if (capacity <= _capacity) return true;
+
+            auto const values = _allocator.allocate(capacity);
+            auto const owners = static_cast<uint32_t*>(xc::reallocate(_owners, capacity * sizeof(uint32_t), Tag));
+            if (!values || !owners) {
+                _allocator.deallocate(values);
+                if (owners) _owners = owners;
+                return false;
+            }
+
+            for (uint32_t i = 0; i < _size; ++i) {
+                _allocator.construct(values + i, move(_values[i]));
+                _allocator.destroy(_values + i);
+            }
+            _allocator.deallocate(_values);
+            _values = values;
+            _owners = owners;
+            _capacity = capacity;
+            return true;
+        }
+
+        [[nodiscard]] auto contains(handle<T> h) const -> bool {
+            auto const index = h.index();
+            return index < _slot_count && _slots[index].generation == h.generation() && _slots[index].link < _size &&
+                   _owners[_slots[index].link] == index;
+        }
+
+        auto get(handle<T> h) -> T* { return contains(h) ? _values + _slots[h.index()].link : nullptr; }
+        auto get(handle<T> h) const -> T const* { return contains(h) ? _values + _slots[h.index()].link : nullptr; }
+
+        // Handle for the value at dense position i
+        [[nodiscard]] auto handle_at(uint32_t i) const -> handle<T> { return handle<T>::make(_owners[i], _slots[_owners[i]].generation); }
+
+        [[nodiscard]] auto size() const -> uint32_t { return _size; }
+        [[nodiscard]] auto capacity() const -> uint32_t { return _capacity; }
+        auto data() -> T* { return _values; }
+        auto data() const -> T const* { return _values; }
+
+        auto begin() -> T* { return _values; }
+        auto end() -> T* { return _values + _size; }
+        auto begin() const -> T const* { return _values; }
+        auto end() const -> T const* { return _values + _size; }
+
+    private:
+        auto static constexpr NONE = ~0u;
+
+        // link is the next free slot while free, and the dense position while live
+        struct slot {
+            uint32_t generation;
+            uint32_t link;
+        };
+
+        T* _values = nullptr;
+        uint32_t* _owners = nullptr;
+        slot* _slots = nullptr;
+        uint32_t _size = 0u;
+        uint32_t _capacity = 0u;
+        uint32_t _slot_count = 0u;
+        uint32_t _slot_capacity = 0u;
+        uint32_t _free = NONE;
+        Allocator _allocator;
+
+        auto grow_slots() -> bool {
+            auto const capacity = _slot_capacity == 0 ? 16u : _slot_capacity * 2u;
+            auto const slots = static_cast<slot*>(xc::reallocate(_slots, capacity * sizeof(slot), Tag));
+            if (!slots) return false;
+            _slots = slots;
+            _slot_capacity = capacity;
+            return true;
+        }
+    };
+
+    // Maps small integer keys, such as entity indices, to values packed in a dense array.  The sparse side is a flat
+    // array indexed by key, so memory grows with the largest key rather than the number of values.  Tag as for
+    // slot_map.  No destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged, typename Allocator = default_allocator<T, Tag>>
+    class sparse_set {
+    public:
+        // Assigns if the key is already present.  ~0u is not a valid key
+        auto insert(uint32_t key, T const& value) -> T* {
+            if (key == NONE) return nullptr;
+            if (auto const existing = get(key)) {
+                *existing = value;
+                return existing;
+            }
+
+            if (key >= _sparse_capacity && !grow_sparse(key + 1u)) return nullptr;
+            if (_size == _capacity && !reserve(_capacity == 0 ? 16u : _capacity * 2u)) return nullptr;
+
+            _allocator.construct(_values + _size, value);
+            _keys[_size] = key;
+            _sparse[key] = _size;
+            return _values + _size++;
+        }
+
+        auto remove(uint32_t key) -> bool {
+            if (!contains(key)) return false;
+
+            auto const position = _sparse[key];
+            auto const last = --_size;
+            if (position != last) {
+                _values[position] = move(_values[last]);
+                _keys[position] = _keys[last];
+                _sparse[_keys[position]] = position;
+            }
+            _allocator.destroy(_values + last);
+            _sparse[key] = NONE;
+            return true;
+        }
+
+        auto clear() -> void {
+            for (uint32_t i = 0; i < _size; ++i) {
+                _sparse[_keys[i]] = NONE;
+                _allocator.destroy(_values + i);
+            }
+            _size = 0u;
+        }
+
+        auto release() -> void {
+            clear();
+            _allocator.deallocate(_values);
+            xc::deallocate(_keys, Tag);
+            xc::deallocate(_sparse, Tag);
+            _values = nullptr;
+            _keys = nullptr;
+            _sparse = nullptr;
+            _capacity = 0u;
+            _sparse_capacity = 0u;
+        }
+
+        auto reserve(uint32_t capacity) -> bool {
+            if (capacity <= _capacity) return true;
+
+            auto const values = _allocator.allocate(capacity);
+            auto const keys = static_cast<uint32_t*>(xc::reallocate(_keys, capacity * sizeof(uint32_t), Tag));
+            if (!values || !keys) {
+                _allocator.deallocate(values);
+                if (keys) _keys = keys;
+                return false;
+            }
+
+            for (uint32_t i = 0; i < _size; ++i) {
+                _allocator.construct(values + i, move(_values[i]));
+                _allocator.destroy(_values + i);
+            }
+            _allocator.deallocate(_values);
+            _values = values;
+            _keys = keys;
+            _capacity = capacity;
+            return true;
+        }
+
+        [[nodiscard]] auto contains(uint32_t key) const -> bool { return key < _sparse_capacity && _sparse[key] != NONE; }
+
+        auto get(uint32_t key) -> T* { return contains(key) ? _values + _sparse[key] : nullptr; }
+        auto get(uint32_t key) const -> T const* { return contains(key) ? _values + _sparse[key] : nullptr; }
+
+        // Keys in the same order as the values
+        auto keys() const -> span<uint32_t const> { return {_keys, _size}; }
+
+        [[nodiscard]] auto size() const -> uint32_t { return _size; }
+        auto data() -> T* { return _values; }
+        auto data() const -> T const* { return _values; }
+
+        auto begin() -> T* { return _values; }
+        auto end() -> T* { return _values + _size; }
+        auto begin() const -> T const* { return _values; }
+        auto end() const -> T const* { return _values + _size; }
+
+    private:
+        auto static constexpr NONE = ~0u;
+
+        T* _values = nullptr;
+        uint32_t* _keys = nullptr;
+        uint32_t* _sparse = nullptr;
+        uint32_t _size = 0u;
+        uint32_t _capacity = 0u;
+        uint32_t _sparse_capacity = 0u;
+        Allocator _allocator;
+
+        // Doubling stops at one slot per valid key rather than wrapping around for keys past 2^31
+        auto grow_sparse(uint32_t min_capacity) -> bool {
+            auto capacity = size_t{_sparse_capacity == 0 ? 64u : _sparse_capacity};
+            while (capacity < min_capacity) capacity = capacity > NONE / 2u ? size_t{NONE} : capacity * 2u;
+            if (capacity > ~size_t{} / sizeof(uint32_t)) return false;
+
+            auto const sparse = static_cast<uint32_t*>(xc::reallocate(_sparse, capacity * sizeof(uint32_t), Tag));
+            if (!sparse) return false;
+            memset(sparse + _sparse_capacity, 0xff, (capacity - _sparse_capacity) * sizeof(uint32_t));
+            _sparse = sparse;
+            _sparse_capacity = static_cast<uint32_t>(capacity);
+            return true;
+        }
+    };
+}
+
+#endif // ENGINE_CORE_SLOT_MAP_H
@@ -0,0 +1,144 @@
+#ifndef ENGINE_CORE_SOA_ARRAY_H
+#define ENGINE_CORE_SOA_ARRAY_H
+
+#include <engine/core/types.h>
+
+namespace xc {
+    template<size_t I, typename T, typename... Rest> struct soa_type_at { using type = typename soa_type_at<I - 1, Rest...>::type; };
+    template<typename T, typename... Rest> struct soa_type_at<0, T, Rest...> { using type = T; };
+
+    // Structure of arrays: element i is the row made of the i-th entry of every column.  Each column is its own
+    // contiguous stream starting on a cache line, and capacity is kept a multiple of LANE_PADDING so kernels can run
+    // full SIMD widths over the tail without a scalar remainder loop.  All columns share one allocation.
+    //
+    // Columns must be trivially copyable; rows are moved with memcpy and never destroyed.  No destructor, call
+    // release() manually
+    template<typename... Ts> class soa_array {
+        static_assert(sizeof...(Ts) > 0, "soa_array needs at least one column");
+        static_assert((__is_trivially_copyable(Ts) && ...), "soa_array columns must be trivially copyable");
+
+    public:
+        template<size_t I> using column_type = typename soa_type_at<I, Ts...>::type;
+
+        auto static constexpr COLUMN_COUNT = sizeof...(Ts);
+        auto static constexpr ALIGNMENT = size_t{64};
+        auto static constexpr LANE_PADDING = size_t{16};
+
+        constexpr soa_array() = default;
+        constexpr explicit soa_array(memory_tag tag) : _tag{tag} {}
+
+        // False if growing failed, leaving the array as it was
+        auto push_back(Ts const&... values) -> bool {
+            if (_size == _capacity && !reserve(_capacity == 0 ? LANE_PADDING : _capacity * 2)) return false;
+            auto i = size_t{};
+            ((static_cast<Ts*>(_columns[i++])[_size] = values), ...);
+            ++_size;
+            return true;
+        }
+
+        auto pop_back() -> void {
+            if (_size > 0) --_size;
+        }
+
+        // Keeps row order by shifting every column down
+        auto erase(size_t index) -> void {
+            if (index >= _size) return;
+            auto const tail = _size - index - 1;
+            auto i = size_t{};
+            ((memmove(static_cast<Ts*>(_columns[i]) + index, static_cast<Ts*>(_columns[i]) + index + 1, tail * sizeof(Ts)), ++i), ...);
+            --_size;
+        }
+
+        // Moves the last row into the hole.  O(1) but doesn't keep order
+        auto swap_remove(size_t index) -> void {
+            if (index >= _size) return;
+            --_size;
+            if (index == _size) return;
+            auto i = size_t{};
+            ((static_cast<Ts*>(_columns[i])[index] = static_cast<Ts*>(_columns[i])[_size], ++i), ...);
+        }
+
+        auto swap(size_t a, size_t b) -> void {
+            auto i = size_t{};
+            ((swap_in(static_cast<Ts*>(_columns[i++]), a, b)), ...);
+        }
+
+        auto reserve(size_t newCapacity) -> bool {
+            newCapacity = (newCapacity + LANE_PADDING - 1) & ~(LANE_PADDING - 1);
+            if (newCapacity <= _capacity) return true;
+
+            auto const block = static_cast<unsigned char*>(xc::allocate(bytes_for(newCapacity) + ALIGNMENT - 1, _tag));
+            if (!block) return false;
+
+            auto offset = (ALIGNMENT - reinterpret_cast<uintptr_t>(block) % ALIGNMENT) % ALIGNMENT;
+            auto i = size_t{};
+            ((place_column<Ts>(block, offset, newCapacity, i++)), ...);
+
+            xc::deallocate(_block, _tag);
+            _block = block;
+            _capacity = newCapacity;
+            return true;
+        }
+
+        // New rows are zeroed.  False if growing failed, leaving the array as it was
+        auto resize(size_t newSize) -> bool {
+            if (newSize > _capacity && !reserve(newSize)) return false;
+            if (newSize > _size) {
+                auto i = size_t{};
+                ((memset(static_cast<Ts*>(_columns[i++]) + _size, 0, (newSize - _size) * sizeof(Ts))), ...);
+            }
+            _size = newSize;
+            return true;
+        }
+
+        auto clear() -> void { _size = 0; }
+
+        auto release() -> void {
+            xc::deallocate(_block, _tag);
+            _block = nullptr;
+            for (auto& c : _columns) c = nullptr;
+            _size = 0;
+            _capacity = 0;
+        }
+
+        template<size_t I> auto column() -> span<column_type<I>> { return {data<I>(), _size}; }
+        template<size_t I> auto column() const -> span<column_type<I> const> { return {data<I>(), _size}; }
+
+        template<size_t I> auto data() -> column_type<I>* { return static_cast<column_type<I>*>(_columns[I]); }
+        template<size_t I> auto data() const -> column_type<I> const* { return static_cast<column_type<I> const*>(_columns[I]); }
+
+        template<size_t I> auto get(size_t index) -> column_type<I>& { return data<I>()[index]; }
+        template<size_t I> auto get(size_t index) const -> column_type<I> const& { return data<I>()[index]; }
+
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto capacity() const -> size_t { return _capacity; }
+
+    private:
+        unsigned char* _block = nullptr;
+        void* _columns[COLUMN_COUNT] = {};
+        size_t _size = 0u;
+        size_t _capacity = 0u;
+        memory_tag _tag = memory_tag::untagged;
+
+        auto static bytes_for(size_t capacity) -> size_t {
+            auto bytes = size_t{};
+            ((bytes += (capacity * sizeof(Ts) + ALIGNMENT - 1) & ~(ALIGNMENT - 1)), ...);
+            return bytes;
+        }
+
+        template<typename T> auto place_column(unsigned char* block, size_t& offset, size_t capacity, size_t index) -> void {
+            auto const column = block + offset;
+            if (_size) memcpy(column, _columns[index], _size * sizeof(T));
+            _columns[index] = column;
+            offset += (capacity * sizeof(T) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        template<typename T> auto static swap_in(T* column, size_t a, size_t b) -> void {
+            auto const t = column[a];
+            column[a] = column[b];
+            column[b] = t;
+        }
+    };
+}
+
+#endif // ENGINE_CORE_SOA_ARRAY_H
@@ -0,0 +1,38 @@
+#ifndef ENGINE_CORE_SPIN_LOCK_H
+#define ENGINE_CORE_SPIN_LOCK_H
+
+#include <engine/core/types.h>
+
+namespace xc {
+    // Test and test-and-set lock for short critical sections.  Zero initialized, so it can live in globals
+    class spin_lock {
+    public:
+        auto lock() -> void {
+            while (_locked.exchange(1u, std::memory_order_acquire))
+                while (_locked.load(std::memory_order_relaxed)) CPU_PAUSE();
+        }
+
+        auto try_lock() -> bool {
+            return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(1u, std::memory_order_acquire);
+        }
+
+        auto unlock() -> void { _locked.store(0u, std::memory_order_release); }
+
+    private:
+        std::atomic<uint32_t> _locked = 0u;
+    };
+
+    class spin_lock_scope {
+    public:
+        explicit spin_lock_scope(spin_lock& lock) : _lock{lock} { _lock.lock(); }
+        ~spin_lock_scope() { _lock.unlock(); }
+
+        spin_lock_scope(spin_lock_scope const&) = delete;
+        auto operator=(spin_lock_scope const&) -> spin_lock_scope& = delete;
+
+    private:
+        spin_lock& _lock;
+    };
+}
+
+#endif // ENGINE_CORE_SPIN_LOCK_H
@@ -4,73 +4,106 @@
 #include <engine/core/types.h>
 
 namespace xc {
+    // Strings of up to INLINE_CAPACITY characters live inside the object, longer ones go to the allocator.  The text
+    // is always NUL terminated, and a zeroed string_t is a valid empty string
     template<typename T = char, typename Allocator = xc::default_allocator<T>> class string_t {
     public:
+        auto static constexpr INLINE_CAPACITY = 24 / sizeof(T) - 2;
+
         string_t() = default;
 
-        explicit string_t(const T* str) {
-            _size = strlen(str);
-            _data = allocate(_size);
-            copy(str, _size);
-        }
+        explicit string_t(const T* str) { assign(str, strlen(str)); }
 
-        template <std::size_t N> explicit string_t(const T (&str)[N]) {
-            _size = N - 1;
-            _data = allocate(_size);
-            copy(str, _size);
-        }
+        template <std::size_t N> explicit string_t(const T (&str)[N]) { assign(str, N - 1); }
 
-        string_t(const string_t &other) {
-            _data = allocate(other.size());
-            copy(other.c_str(), other.size());
-            _size = other.size();
-        }
+        string_t(const string_t &other) { assign(other.c_str(), other.size()); }
+        string_t(string_t &&other) { take(other); }
 
-        ~string_t() {
-            clear();
-            deallocate(_data);
-        }
+        ~string_t() { release(); }
 
 
         explicit operator uint64_t() const { return static_cast<uint64_t>(wyhash(c_str(), size())); }
 
-        auto operator!=(const string_t& other) const -> bool { return *this != other; }
+        auto operator!=(const string_t& other) const -> bool { return !(*this == other); }
         auto operator==(const string_t& other) const -> bool {
-            return (_size == other._size) && (memcmp(_data, other._data, _size * sizeof(T)) == 0);
+            auto const length = size();
+            auto const data = c_str(), other_data = other.c_str();
+            return length == other.size() && (data == other_data || memcmp(data, other_data, length * sizeof(T)) == 0);
+        }
+        auto operator==(const T* str) const -> bool {
+            auto const length = size();
+            return length == strlen(str) && memcmp(c_str(), str, length * sizeof(T)) == 0;
         }
         auto operator=(const string_t &other) -> string_t& {
+            if (this != &other) assign(other.c_str(), other.size());
+            return *this;
+        }
+        auto operator=(string_t &&other) -> string_t& {
             if (this != &other) {
-                clear();
-                deallocate(_data);
-                _data = allocate(other.size());
-                copy(other.c_str(), other.size());
-                _size = other.size();
+                release();
+                take(other);
             }
             return *this;
         }
 
-        [[nodiscard]] auto size() const -> size_t { return _size; }
-        [[nodiscard]] auto c_str() const -> T const * { return _data; }
+        [[nodiscard]] auto size() const -> size_t {
+            return is_inline() ? static_cast<size_t>(_inline[LAST]) : _heap.size;
+        }
+        [[nodiscard]] auto capacity() const -> size_t { return is_inline() ? INLINE_CAPACITY : _heap.capacity & ~HEAP; }
+        [[nodiscard]] auto c_str() const -> T const * { return is_inline() ? _inline : _heap.data; }
+        [[nodiscard]] auto is_inline() const -> bool { return !(_heap.capacity & HEAP); }
 
     private:
-        T *_data = {};
-        size_t _size = {};
-        Allocator _allocator = {};
+        // Inline strings keep their size in the last element, which overlays the top of the heap capacity (x86 is
+        // little endian).  Heap strings set the top bit of the capacity, which no inline size reaches
+        auto static constexpr LAST = 24 / sizeof(T) - 1;
+        auto static constexpr HEAP = size_t{1} << 63u;
+
+        struct heap {
+            T *data;
+            size_t size;
+            size_t capacity;
+        };
+
+        union {
+            T _inline[LAST + 1] = {};
+            heap _heap;
+        };
+        [[no_unique_address]] Allocator _allocator = {};
+
+        static_assert(sizeof(T) <= sizeof(size_t) && sizeof(_inline) == sizeof(heap));
 
         auto allocate(size_t n) -> T * { return _allocator.allocate(n); }
         auto deallocate(T *ptr) -> void { _allocator.deallocate(ptr); }
 
-        auto copy(const T *source, std::size_t length) -> void {
-            memcpy(_data, source, length * sizeof(T));
-            _data[length] = '\0';
+        // Reuses the current buffer when the text fits
+        auto assign(const T *source, size_t length) -> void {
+            if (length > capacity()) {
+                release();
+                _heap = {allocate(length + 1), length, length | HEAP};
+            }
+
+            auto const data = is_inline() ? _inline : _heap.data;
+            memmove(data, source, length * sizeof(T));
+            data[length] = '\0';
+            if (is_inline()) _inline[LAST] = static_cast<T>(length);
+            else _heap.size = length;
         }
 
-        auto clear() -> void {
-            memset(_data, 0, _size * sizeof(T));
-            _size = 0;
+        // Steals other's heap buffer, or copies its inline text, and leaves it empty
+        auto take(string_t &other) -> void {
+            memcpy(static_cast<void*>(_inline), other._inline, sizeof(_inline));
+            other.reset();
         }
 
-        auto strlen(const char *str) -> size_t {
+        auto release() -> void {
+            if (!is_inline()) deallocate(_heap.data);
+            reset();
+        }
+
+        auto reset() -> void { memset(static_cast<void*>(_inline), 0, sizeof(_inline)); }
+
+        auto static strlen(const T *str) -> size_t {
             size_t length = 0;
             while (str[length] != '\0') ++length;
             return length;
@@ -78,6 +111,8 @@ namespace xc {
     };
 
     using string = string_t<char>;
+
+    static_assert(sizeof(string) == 24u);
 }
 
 #endif // ENGINE_CORE_STRING_H
@@ -0,0 +1,174 @@
+#ifndef ENGINE_CORE_STRING_ID_H
+#define ENGINE_CORE_STRING_ID_H
+
+#include <engine/core/types.h>
+#include <engine/core/arena.h>
+#include <engine/core/epoch.h>
+#include <engine/core/spin_lock.h>
+
+namespace xc {
+    // Table of interned strings shared by every thread.  Text is copied once into an arena and never freed; its index
+    // is the string's id.  Lookups by id read a chunked index that never moves, and lookups by text probe an open
+    // addressing table of ids that writers replace wholesale when it grows, so readers take no locks.  Interning new
+    // text serializes on one lock
+    class intern_table {
+    public:
+        auto static constexpr CHUNK_SIZE = 1024u;
+        auto static constexpr MAX_CHUNKS = 1024u;
+
+        // Returned by intern() once the table is full or out of memory.  It names no string, so no real id equals it
+        auto static constexpr INVALID_ID = ~0u;
+
+        // Id 0 is the empty string
+        auto intern(char const* text) -> uint32_t {
+            auto const size = length_of(text);
+            if (size == 0) return 0u;
+
+            auto const h = wyhash(text, size);
+            if (auto const id = find(text, size, h)) return id;
+
+            spin_lock_scope scope{_lock};
+            if (auto const id = find(text, size, h)) return id;
+
+            auto const id = _count + 1u;
+            if (id >= CHUNK_SIZE * MAX_CHUNKS) return INVALID_ID;
+
+            // Every allocation comes before the entry is published, so running out leaves the table as it was
+            if (id * 4u > capacity_of(_slots.load(std::memory_order_relaxed)) * 3u && !grow()) return INVALID_ID;
+
+            auto& chunk = _chunks[id / CHUNK_SIZE];
+            auto entries = chunk.load(std::memory_order_relaxed);
+            if (!entries) {
+                entries = static_cast<entry*>(xc::allocate(CHUNK_SIZE * sizeof(entry), memory_tag::core));
+                if (!entries) return INVALID_ID;
+                chunk.store(entries, std::memory_order_release);
+            }
+
+            auto const copy = static_cast<char*>(_text.allocate(size + 1, 1));
+            if (!copy) return INVALID_ID;
+            memcpy(copy, text, size + 1);
+
+            entries[id % CHUNK_SIZE] = {copy, size, h};
+            insert(_slots.load(std::memory_order_relaxed), id, h);
+            _count = id;
+            return id;
+        }
+
+        // Returns 0 if the text was never interned
+        auto find(char const* text) const -> uint32_t {
+            auto const size = length_of(text);
+            return size ? find(text, size, wyhash(text, size)) : 0u;
+        }
+
+        // Ids come from intern(), so their entries are already published.  INVALID_ID reads as the empty string
+        auto text(uint32_t id) const -> char const* { return has_entry(id) ? entry_of(id).text : ""; }
+        auto size(uint32_t id) const -> size_t { return has_entry(id) ? entry_of(id).size : 0u; }
+        auto hash(uint32_t id) const -> uint64_t { return has_entry(id) ? entry_of(id).hash : 0u; }
+
+    private:
+        struct entry {
+            char const* text;
+            size_t size;
+            uint64_t hash;
+        };
+
+        // Slot values are ids, 0 for empty.  The capacity is stored in front of the slots
+        using slot = std::atomic<uint32_t>;
+
+        spin_lock _lock;
+        linear_arena _text;
+        std::atomic<slot*> _slots;
+        std::atomic<entry*> _chunks[MAX_CHUNKS];
+        uint32_t _count = 0u;
+
+        auto static length_of(char const* text) -> size_t {
+            auto length = size_t{};
+            while (text[length]) ++length;
+            return length;
+        }
+
+        auto static has_entry(uint32_t id) -> bool { return id != 0u && id != INVALID_ID; }
+
+        auto static capacity_of(slot* slots) -> uint32_t { return slots ? slots[-1].load(std::memory_order_relaxed) : 0u; }
+
+        auto entry_of(uint32_t id) const -> entry const& {
+            return _chunks[id / CHUNK_SIZE].load(std::memory_order_acquire)[id % CHUNK_SIZE];
+        }
+
+        auto find(char const* text, size_t size, uint64_t h) const -> uint32_t {
+            epoch::guard guard;
+            auto const slots = _slots.load(std::memory_order_acquire);
+            if (!slots) return 0u;
+
+            auto const mask = capacity_of(slots) - 1u;
+            for (auto i = static_cast<uint32_t>(h) & mask;; i = (i + 1u) & mask) {
+                auto const id = slots[i].load(std::memory_order_acquire);
+                if (!id) return 0u;
+
+                auto const& e = entry_of(id);
+                if (e.hash == h && e.size == size && memcmp(e.text, text, size) == 0) return id;
+            }
+        }
+
+        auto static insert(slot* slots, uint32_t id, uint64_t h) -> void {
+            auto const mask = capacity_of(slots) - 1u;
+            auto i = static_cast<uint32_t>(h) & mask;
+            while (slots[i].load(std::memory_order_relaxed)) i = (i + 1u) & mask;
+            slots[i].store(id, std::memory_order_release);
+        }
+
+        auto static free_slots(void* ptr) -> void { xc::deallocate(static_cast<slot*>(ptr) - 1, memory_tag::core); }
+
+        // False, with the old table still in place, if the new one couldn't be allocated
+        auto grow() -> bool {
+            auto const old = _slots.load(std::memory_order_relaxed);
+            auto const capacity = old ? capacity_of(old) * 2u : 256u;
+
+            auto const block = static_cast<slot*>(xc::allocate((capacity + 1u) * sizeof(slot), memory_tag::core));
+            if (!block) return false;
+            memset(static_cast<void*>(block), 0, (capacity + 1u) * sizeof(slot));
+            block[0].store(capacity, std::memory_order_relaxed);
+
+            auto const slots = block + 1;
+            for (auto id = 1u; id <= _count; ++id) insert(slots, id, entry_of(id).hash);
+            _slots.store(slots, std::memory_order_release);
+
+            if (old) epoch::retire(old, free_slots);
+            return true;
+        }
+    };
+
+    inline constinit intern_table global_intern_table = {};
+
+    // Interned string.  Equality and hashing compare ids, and the text stays valid for the life of the program
+    class string_id {
+    public:
+        constexpr string_id() = default;
+        // Invalid if the intern table is full or out of memory
+        explicit string_id(char const* text) : _id{global_intern_table.intern(text)} {}
+
+        // The id for text that was already interned, or the empty id
+        auto static find(char const* text) -> string_id {
+            auto id = string_id{};
+            id._id = global_intern_table.find(text);
+            return id;
+        }
+
+        [[nodiscard]] auto c_str() const -> char const* { return global_intern_table.text(_id); }
+        [[nodiscard]] auto size() const -> size_t { return global_intern_table.size(_id); }
+        [[nodiscard]] auto value() const -> uint32_t { return _id; }
+        [[nodiscard]] auto empty() const -> bool { return _id == 0u; }
+        [[nodiscard]] auto valid() const -> bool { return _id != intern_table::INVALID_ID; }
+
+        explicit operator uint64_t() const { return _id; }
+
+        // An invalid id equals nothing, itself included, so two strings that both failed to intern never match
+        auto operator==(string_id other) const -> bool { return _id == other._id && valid(); }
+        auto operator!=(string_id other) const -> bool { return !(*this == other); }
+
+    private:
+        uint32_t _id = 0u;
+    };
+}
+
+#endif // ENGINE_CORE_STRING_ID_H
@@ -0,0 +1,278 @@
+#ifndef ENGINE_CORE_SYNC_H
+#define ENGINE_CORE_SYNC_H
+
+#include <engine/core/types.h>
+
+// Blocking primitives on top of wait_on_address() and wake_on_address(), which the platform layer implements with a
+// raw futex on Linux, WaitOnAddress on Windows and __ulock on macOS.  Each one spins briefly before parking, and only
+// calls into the kernel to wake someone when a thread is actually parked, so uncontended use never leaves user space.
+// All constexpr constructible, so they can live in globals
+namespace xc {
+    // Mutex ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Drepper's three state futex mutex ("Futexes Are Tricky"): 0 unlocked, 1 locked, 2 locked with threads parked.
+    // The spin limit adapts like glibc's adaptive mutex: it follows how long acquiring took recently, so a lock held
+    // for a few instructions is spun for and one held across a syscall goes straight to sleep
+    class mutex {
+    public:
+        auto lock() -> void {
+            auto expected = 0u;
+            if (!_state.compare_exchange_strong(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed)) lock_contended();
+        }
+
+        auto try_lock() -> bool {
+            auto expected = 0u;
+            return _state.compare_exchange_strong(expected, 1u, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        auto unlock() -> void {
+            if (_state.exchange(0u, std::memory_order_release) == 2u) wake_on_address(_state, 1u);
+        }
+
+    private:
+        auto static constexpr MAX_SPINS = 256u;
+
+        std::atomic<uint32_t> _state = 0u;
+        std::atomic<uint32_t> _spins = 0u;   // running average of the spins it took to acquire, updated racily
+
+        auto lock_contended() -> void {
+            auto const average = _spins.load(std::memory_order_relaxed);
+            auto const limit = average * 2u + 16u < MAX_SPINS ? average * 2u + 16u : MAX_SPINS;
+
+            auto spins = 0u;
+            for (; spins < limit; ++spins) {
+                CPU_PAUSE();
+                if (_state.load(std::memory_order_relaxed) == 0u && try_lock()) break;
+            }
+            auto const moved = (static_cast<int32_t>(spins) - static_cast<int32_t>(average)) / 8;
+            _spins.store(static_cast<uint32_t>(static_cast<int32_t>(average) + moved), std::memory_order_relaxed);
+            if (spins < limit) return;
+
+            // Whoever holds it now will see 2 and wake someone.  Taking it with 2 rather than 1 may cost a spurious
+            // wake later, but never a lost one
+            while (_state.exchange(2u, std::memory_order_acquire) != 0u) wait_on_address(_state, 2u);
+        }
+    };
+
+    class mutex_scope {
+    public:
+        explicit mutex_scope(mutex& lock) : _lock{lock} { _lock.lock(); }
+        ~mutex_scope() { _lock.unlock(); }
+
+        mutex_scope(mutex_scope const&) = delete;
+        auto operator=(mutex_scope const&) -> mutex_scope& = delete;
+
+    private:
+        mutex& _lock;
+    };
+
+    // Reader Writer Lock //////////////////////////////////////////////////////////////////////////////////////////////
+    // Any number of readers or one writer.  Writer preferring: new readers queue up behind a waiting writer, so a
+    // steady stream of readers can't starve it.  Everyone parks on the state word, and releases that let others in wake
+    // them all, which suits locks that are read often and written rarely
+    class rw_lock {
+    public:
+        auto lock_shared() -> void {
+            for (auto spins = 0u;; ++spins) {
+                if (try_lock_shared()) return;
+                if (spins < SPINS) {
+                    CPU_PAUSE();
+                    continue;
+                }
+                park(_state.load(std::memory_order_relaxed));
+            }
+        }
+
+        auto try_lock_shared() -> bool {
+            auto state = _state.load(std::memory_order_relaxed);
+            while (!(state & WRITER) && _writers_waiting.load(std::memory_order_relaxed) == 0u) {
+                if (_state.compare_exchange_weak(state, state + 1u, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+
+        auto unlock_shared() -> void {
+            if (_state.fetch_sub(1u, std::memory_order_seq_cst) == 1u && _sleepers.load(std::memory_order_seq_cst)) wake_on_address(_state, ~0u);
+        }
+
+        auto lock() -> void {
+            if (try_lock()) return;
+
+            _writers_waiting.fetch_add(1u, std::memory_order_relaxed);
+            for (auto spins = 0u;; ++spins) {
+                auto expected = 0u;
+                if (_state.compare_exchange_weak(expected, WRITER, std::memory_order_acquire, std::memory_order_relaxed)) break;
+                if (spins < SPINS) {
+                    CPU_PAUSE();
+                    continue;
+                }
+                park(expected);
+            }
+            _writers_waiting.fetch_sub(1u, std::memory_order_relaxed);
+        }
+
+        auto try_lock() -> bool {
+            auto expected = 0u;
+            return _state.compare_exchange_strong(expected, WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        auto unlock() -> void {
+            _state.store(0u, std::memory_order_seq_cst);
+            if (_sleepers.load(std::memory_order_seq_cst)) wake_on_address(_state, ~0u);
+        }
+
+    private:
+        auto static constexpr WRITER = 1u << 31u;
+        auto static constexpr SPINS = 128u;
+
+        std::atomic<uint32_t> _state = 0u;   // WRITER, or the number of readers
+        std::atomic<uint32_t> _writers_waiting = 0u;
+        std::atomic<uint32_t> _sleepers = 0u;
+
+        // Sleep unless the state moved on since we looked.  Releases that could let someone in change the state and
+        // then check _sleepers, so either they see us or we see their change
+        auto park(uint32_t seen) -> void {
+            _sleepers.fetch_add(1u, std::memory_order_seq_cst);
+            if (_state.load(std::memory_order_seq_cst) == seen) wait_on_address(_state, seen);
+            _sleepers.fetch_sub(1u, std::memory_order_relaxed);
+        }
+    };
+
+    class read_scope {
+    public:
+        explicit read_scope(rw_lock& lock) : _lock{lock} { _lock.lock_shared(); }
+        ~read_scope() { _lock.unlock_shared(); }
+
+        read_scope(read_scope const&) = delete;
+        auto operator=(read_scope const&) -> read_scope& = delete;
+
+    private:
+        rw_lock& _lock;
+    };
+
+    class write_scope {
+    public:
+        explicit write_scope(rw_lock& lock) : _lock{lock} { _lock.lock(); }
+        ~write_scope() { _lock.unlock(); }
+
+        write_scope(write_scope const&) = delete;
+        auto operator=(write_scope const&) -> write_scope& = delete;
+
+    private:
+        rw_lock& _lock;
+    };
+
+    // Semaphore ///////////////////////////////////////////////////////////////////////////////////////////////////////
+    class semaphore {
+    public:
+        constexpr semaphore() = default;
+        constexpr explicit semaphore(uint32_t count) : _count{count} {}
+
+        auto acquire() -> void {
+            for (auto spins = 0u;; ++spins) {
+                if (try_acquire()) return;
+                if (spins < SPINS) {
+                    CPU_PAUSE();
+                    continue;
+                }
+
+                _waiters.fetch_add(1u, std::memory_order_seq_cst);
+                if (_count.load(std::memory_order_seq_cst) == 0u) wait_on_address(_count, 0u);
+                _waiters.fetch_sub(1u, std::memory_order_relaxed);
+            }
+        }
+
+        auto try_acquire() -> bool {
+            auto count = _count.load(std::memory_order_relaxed);
+            while (count) {
+                if (_count.compare_exchange_weak(count, count - 1u, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+
+        auto release(uint32_t count = 1u) -> void {
+            _count.fetch_add(count, std::memory_order_seq_cst);
+            if (_waiters.load(std::memory_order_seq_cst)) wake_on_address(_count, count);
+        }
+
+    private:
+        auto static constexpr SPINS = 128u;
+
+        std::atomic<uint32_t> _count = 0u;
+        std::atomic<uint32_t> _waiters = 0u;
+    };
+
+    // Event ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // One shot: once set, every wait returns at once.  reset() is for reusing it, such as once per frame, and must not
+    // race with waits
+    class event {
+    public:
+        auto set() -> void {
+            if (_state.exchange(SET, std::memory_order_release) == WAITING) wake_on_address(_state, ~0u);
+        }
+
+        auto wait() -> void {
+            for (auto spins = 0u; spins < SPINS; ++spins) {
+                if (is_set()) return;
+                CPU_PAUSE();
+            }
+
+            // Flag that someone sleeps, so set() knows to wake
+            auto state = _state.load(std::memory_order_acquire);
+            while (state != SET) {
+                if (state == UNSET && !_state.compare_exchange_weak(state, WAITING, std::memory_order_acquire, std::memory_order_acquire)) continue;
+                wait_on_address(_state, WAITING);
+                state = _state.load(std::memory_order_acquire);
+            }
+        }
+
+        [[nodiscard]] auto is_set() const -> bool { return _state.load(std::memory_order_acquire) == SET; }
+        auto reset() -> void { _state.store(UNSET, std::memory_order_relaxed); }
+
+    private:
+        auto static constexpr UNSET = 0u;
+        auto static constexpr SET = 1u;
+        auto static constexpr WAITING = 2u;
+        auto static constexpr SPINS = 128u;
+
+        std::atomic<uint32_t> _state = UNSET;
+    };
+
+    // Barrier /////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Reusable: the last of count threads to arrive releases the others and starts the next generation
+    class barrier {
+    public:
+        constexpr explicit barrier(uint32_t count) : _count{count} {}
+
+        // True on exactly one thread per generation, for work that should happen once between phases
+        auto arrive_and_wait() -> bool {
+            auto const generation = _generation.load(std::memory_order_acquire);
+            if (_arrived.fetch_add(1u, std::memory_order_acq_rel) + 1u == _count) {
+                _arrived.store(0u, std::memory_order_relaxed);
+                _generation.fetch_add(1u, std::memory_order_seq_cst);
+                if (_waiters.load(std::memory_order_seq_cst)) wake_on_address(_generation, ~0u);
+                return true;
+            }
+
+            for (auto spins = 0u; _generation.load(std::memory_order_acquire) == generation; ++spins) {
+                if (spins < SPINS) {
+                    CPU_PAUSE();
+                    continue;
+                }
+                _waiters.fetch_add(1u, std::memory_order_seq_cst);
+                if (_generation.load(std::memory_order_seq_cst) == generation) wait_on_address(_generation, generation);
+                _waiters.fetch_sub(1u, std::memory_order_relaxed);
+            }
+            return false;
+        }
+
+    private:
+        auto static constexpr SPINS = 256u;
+
+        uint32_t _count;
+        std::atomic<uint32_t> _arrived = 0u;
+        std::atomic<uint32_t> _generation = 0u;
+        std::atomic<uint32_t> _waiters = 0u;
+    };
+}
+
+#endif // ENGINE_CORE_SYNC_H
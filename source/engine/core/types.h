@@ -1,6 +1,7 @@
 #ifndef ENGINE_CORE_CORE_TYPES_H
 #define ENGINE_CORE_CORE_TYPES_H
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -34,11 +35,26 @@
 #define CDECL
 #endif
 
+// Spin-wait hint
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CPU_PAUSE() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#define CPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_PAUSE() asm volatile ("yield")
+#else
+#define CPU_PAUSE() do {} while (0)
+#endif
+
 
 extern "C" {
     auto extern CDECL memcpy(void *dest, const void *src, size_t size) -> void*;
+    auto extern CDECL memmove(void *dest, const void *src, size_t size) -> void*;
     auto extern CDECL memset(void *ptr, int value, size_t size) -> void*;
+    auto extern CDECL memcmp(const void *lhs, const void *rhs, size_t size) -> int;
     auto extern CDECL malloc(size_t size) -> void*;
+    auto extern CDECL realloc(void *ptr, size_t size) -> void*;
     auto extern CDECL free(void *ptr) -> void;
 }
 
@@ -67,10 +83,30 @@ auto constexpr wyhash(const char* str, uint64_t seed = 0) -> uint64_t {
 }
 
 namespace xc {
-    template<typename T> class default_allocator {
+    // Allocation tags for memory telemetry.  A block must be freed with the tag it was allocated with
+    enum class memory_tag : uint8_t { untagged, core, renderer, game, count };
+
+    // Implemented by the platform layer
+    auto allocate(size_t size, memory_tag tag) -> void*;
+    auto deallocate(void* ptr, memory_tag tag) -> void;
+    auto reallocate(void* ptr, size_t size, memory_tag tag) -> void*;
+
+    // Futex style parking, also implemented by the platform layer.  wait_on_address() sleeps while word still holds
+    // expected and may return spuriously, so callers re-check their condition in a loop
+    auto wait_on_address(std::atomic<uint32_t>& word, uint32_t expected) -> void;
+    auto wake_on_address(std::atomic<uint32_t>& word, uint32_t count) -> void;
+
+    // Types whose objects can be moved to a new address with a plain byte copy, leaving nothing to destroy at the
+    // old one.  Specialize for types that own resources but don't point into themselves
+    template<typename T> inline constexpr bool is_trivially_relocatable = __is_trivially_copyable(T);
+
+    template<typename T, memory_tag Tag = memory_tag::untagged> class default_allocator {
     public:
-        auto allocate(size_t n) -> T* { return static_cast<T*>(malloc(n * sizeof(T))); }
-        auto deallocate(T* ptr) -> void { free(ptr); }
+        auto allocate(size_t n) -> T* { return static_cast<T*>(xc::allocate(n * sizeof(T), Tag)); }
+        auto deallocate(T* ptr) -> void { xc::deallocate(ptr, Tag); }
+
+        // Only valid for trivially relocatable T; contents are moved bytewise and the block may change address
+        auto reallocate(T* ptr, size_t n) -> T* { return static_cast<T*>(xc::reallocate(ptr, n * sizeof(T), Tag)); }
 
         template<typename... Args> auto construct(T* ptr, Args&&... args) -> void { *ptr = T(args...); }
         auto destroy(T* ptr) -> void { ptr->~T(); }
@@ -116,6 +152,25 @@ namespace xc {
     };
 
 
+    // Non-owning view of a contiguous run of elements
+    template<typename T> class span {
+    public:
+        constexpr span() = default;
+        constexpr span(T* data, size_t size) : _data{data}, _size{size} {}
+
+        auto operator[](size_t index) const -> T& { return _data[index]; }
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto data() const -> T* { return _data; }
+
+        auto begin() const -> T* { return _data; }
+        auto end() const -> T* { return _data + _size; }
+
+    private:
+        T* _data = nullptr;
+        size_t _size = 0u;
+    };
+
+
     // Math types
     template<typename T, int N> struct vector;
     template<typename T> struct vector<T,1> { T x; };
@@ -129,12 +184,15 @@ namespace xc {
     template<typename T, int M> struct matrix<T,M,3> { vector<T,M> x, y, z; };
     template<typename T, int M> struct matrix<T,M,4> { vector<T,M> x, y, z, w; };
 
+    template<typename T> struct quaternion_t { T x, y, z, w; };
+
     using vector2 = vector<float,2>;
     using vector3 = vector<float,3>;
     using vector4 = vector<float,4>;
     using matrix2 = matrix<float,2,2>;
     using matrix3 = matrix<float,3,3>;
     using matrix4 = matrix<float,4,4>;
+    using quaternion = quaternion_t<float>;
 }
 
 #endif // ENGINE_CORE_CORE_TYPES_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef ENGINE_CORE_WORK_DEQUE_H
+#define ENGINE_CORE_WORK_DEQUE_H
+
+#include <engine/core/types.h>
+#include <engine/core/ring_buffer.h>
+
+namespace xc {
+    // Chase-Lev work stealing deque (with the memory orders of Lê et al., "Correct and Efficient Work-Stealing for
+    // Weak Memory Models").  The owning thread pushes and pops at the bottom like a stack, which keeps recently
+    // spawned work hot in its cache; any other thread steals from the top, taking the oldest and usually largest piece
+    // of work.  Only the last element makes the owner and thieves race, settled by one CAS on top.
+    //
+    // Fixed capacity, rounded up to a power of two: push() fails when full instead of growing, so callers need a
+    // fallback such as running the work inline.  Elements are pointers so a thief never reads a torn value.  No
+    // destructor, call release() manually
+    template<typename T, memory_tag Tag = memory_tag::untagged> class work_deque {
+    public:
+        auto initialize(uint32_t capacity) -> bool {
+            if (capacity == 0 || capacity > (1u << 30)) return false;
+            auto size = int64_t{1};
+            while (size < capacity) size <<= 1;
+
+            _data = static_cast<std::atomic<T*>*>(xc::allocate(static_cast<size_t>(size) * sizeof(std::atomic<T*>), Tag));
+            if (!_data) return false;
+            for (int64_t i = 0; i < size; ++i) _data[i].store(nullptr, std::memory_order_relaxed);
+            _mask = size - 1;
+            _top.store(0, std::memory_order_relaxed);
+            _bottom.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        auto release() -> void {
+            xc::deallocate(_data, Tag);
+            _data = nullptr;
+            _mask = 0;
+        }
+
+        // Owner side
+        auto push(T* value) -> bool {
+            auto const bottom = _bottom.load(std::memory_order_relaxed);
+            auto const top = _top.load(std::memory_order_acquire);
+            if (bottom - top > _mask) return false;
+
+            _data[bottom & _mask].store(value, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Newest element, or null when empty
+        auto pop() -> T* {
+            auto const bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            auto value = _data[bottom & _mask].load(std::memory_order_relaxed);
+            if (top == bottom) {
+                // Last one: a thief may be taking it too
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) value = nullptr;
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return value;
+        }
+
+        // Any thread.  Oldest element, or null when empty or when another thief or the owner won the race for it
+        auto steal() -> T* {
+            auto top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto const bottom = _bottom.load(std::memory_order_acquire);
+            if (top >= bottom) return nullptr;
+
+            auto const value = _data[top & _mask].load(std::memory_order_relaxed);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+            return value;
+        }
+
+        // Only a snapshot while thieves are running
+        [[nodiscard]] auto size() const -> size_t {
+            auto const count = _bottom.load(std::memory_order_acquire) - _top.load(std::memory_order_acquire);
+            return count > 0 ? static_cast<size_t>(count) : 0u;
+        }
+        [[nodiscard]] auto capacity() const -> size_t { return _data ? static_cast<size_t>(_mask + 1) : 0u; }
+
+    private:
+        // Thieves hammer top while the owner works at the bottom, so they live on separate lines
+        alignas(CACHE_LINE_SIZE) std::atomic<int64_t> _top = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<int64_t> _bottom = 0;
+        std::atomic<T*>* _data = nullptr;
+        int64_t _mask = 0;
+    };
+}
+
+#endif // ENGINE_CORE_WORK_DEQUE_H
@@ -0,0 +1,720 @@
+#include <engine/platform/platform_system.h>
+#include <engine/core/spin_lock.h>
+#include <engine/platform/linux/platform_syscall_linux.h>
+
+#include <errno.h>
+#include <sys/mman.h>
+
+// Slab Allocator //////////////////////////////////////////////////////////////////////////////////////////////////////
+// Small blocks come from 1 MiB slabs carved out of one large address range reserved up front.  Every slab serves a
+// single size class, so free() finds the slab by masking the pointer.  Anything above the largest class is mapped
+// directly with a header in front of it.
+//
+// Each thread keeps a magazine of free blocks per size class in front of the shared heap.  Blocks move between a
+// magazine and the heap in batches under the class lock, so most allocations and frees touch no shared state.  A block
+// freed on another thread simply lands in that thread's magazine and flows back to the heap with the next batch.
+auto static constexpr PAGE_SIZE = size_t{4096};
+auto static constexpr SLAB_SIZE = size_t{1} << 20;
+auto static constexpr SPAN_SIZE = size_t{32} << 20;
+auto static constexpr HEAP_RESERVE = size_t{64} << 30;
+auto static constexpr LARGE_HEADER_SIZE = size_t{64};
+
+auto static constexpr MAX_SMALL_SIZE = size_t{128} << 10;
+auto static constexpr SIZE_CLASS_COUNT = 48u;
+
+struct slab {
+    slab* next;
+    slab* prev;
+    void* free_list;   // freed blocks, linked through their first word
+    char* bump;        // blocks past this were never handed out
+    uint32_t size_class;
+    uint32_t used;
+    uint32_t capacity;
+    uint32_t block_size;
+};
+
+auto static constexpr SLAB_HEADER_SIZE = size_t{64};
+static_assert(sizeof(slab) <= SLAB_HEADER_SIZE);
+
+struct large_header {
+    size_t mapped_size;
+    size_t size;
+    size_t offset;   // from the start of the mapping to the header, only over-aligned blocks have one
+};
+
+struct alignas(64) size_class_heap {
+    xc::spin_lock lock;
+    slab* partial;
+};
+
+struct heap {
+    std::atomic<char*> base;
+    std::atomic<char*> end;
+    xc::spin_lock slab_lock;   // guards committed and free_slabs
+    char* committed;       // end of the committed spans
+    slab* free_slabs;
+    size_class_heap classes[SIZE_CLASS_COUNT];
+};
+
+struct magazine {
+    void* head;
+    uint32_t count;
+};
+
+struct thread_cache {
+    magazine magazines[SIZE_CLASS_COUNT];
+};
+
+// malloc runs long before any static constructor could, so these must be constant initialized
+constinit static heap global_heap = {};
+constinit static thread_local thread_cache cache = {};
+
+// Classes are 16 byte steps up to 128, then four steps per power of two up to MAX_SMALL_SIZE
+auto static constexpr size_class_of(size_t size) -> uint32_t {
+    if (size <= 128) return size == 0 ? 0u : static_cast<uint32_t>((size - 1) >> 4);
+    auto const shift = static_cast<uint32_t>(63 - __builtin_clzll(size - 1));
+    return 8u + (shift - 7u) * 4u + static_cast<uint32_t>((size - 1) >> (shift - 2)) - 4u;
+}
+
+auto static constexpr size_of_class(uint32_t size_class) -> size_t {
+    if (size_class < 8) return (size_class + 1) * size_t{16};
+    auto const base = size_t{128} << ((size_class - 8) / 4);
+    return base + ((size_class - 8) % 4 + 1) * (base / 4);
+}
+
+static_assert(size_class_of(MAX_SMALL_SIZE) == SIZE_CLASS_COUNT - 1);
+static_assert(size_of_class(SIZE_CLASS_COUNT - 1) == MAX_SMALL_SIZE);
+static_assert(size_of_class(size_class_of(129)) == 160 && size_of_class(size_class_of(257)) == 320);
+
+// Blocks moved between a magazine and the heap at once.  Roughly 32 KiB worth, but never fewer than 4 or more than 64
+auto static constexpr batch_size_of(uint32_t size_class) -> uint32_t {
+    auto const count = (size_t{32} << 10) / size_of_class(size_class);
+    return count < 4 ? 4u : count > 64 ? 64u : static_cast<uint32_t>(count);
+}
+
+auto static in_heap(void const* ptr) -> bool {
+    auto const p = static_cast<char const*>(ptr);
+    return p >= global_heap.base.load(std::memory_order_relaxed) && p < global_heap.end.load(std::memory_order_relaxed);
+}
+
+auto static slab_of(void* ptr) -> slab* {
+    auto const base = global_heap.base.load(std::memory_order_relaxed);
+    auto const offset = static_cast<size_t>(static_cast<char*>(ptr) - base) & ~(SLAB_SIZE - 1);
+    return reinterpret_cast<slab*>(base + offset);
+}
+
+auto static reserve_heap() -> bool {
+    auto const base = xc::platform::reserve_memory(HEAP_RESERVE);
+    if (!base) return false;
+
+    global_heap.committed = static_cast<char*>(base);
+    global_heap.end.store(static_cast<char*>(base) + HEAP_RESERVE, std::memory_order_relaxed);
+    global_heap.base.store(static_cast<char*>(base), std::memory_order_release);
+    return true;
+}
+
+// Called with slab_lock held
+auto static take_free_slab() -> slab* {
+    auto s = global_heap.free_slabs;
+    if (s) {
+        global_heap.free_slabs = s->next;
+        return s;
+    }
+
+    if (!global_heap.committed && !reserve_heap()) return nullptr;
+    if (global_heap.committed == global_heap.end.load(std::memory_order_relaxed)) return nullptr;
+
+    // Commit a whole span and push all but the first slab onto the free list
+    auto const span = global_heap.committed;
+    if (!xc::platform::commit_memory(span, SPAN_SIZE)) return nullptr;
+    global_heap.committed += SPAN_SIZE;
+
+    for (auto offset = SPAN_SIZE - SLAB_SIZE; offset >= SLAB_SIZE; offset -= SLAB_SIZE) {
+        auto const next = reinterpret_cast<slab*>(span + offset);
+        next->next = global_heap.free_slabs;
+        global_heap.free_slabs = next;
+    }
+    return reinterpret_cast<slab*>(span);
+}
+
+auto static acquire_slab(uint32_t size_class) -> slab* {
+    global_heap.slab_lock.lock();
+    auto const s = take_free_slab();
+    global_heap.slab_lock.unlock();
+    if (!s) return nullptr;
+
+    auto const block_size = size_of_class(size_class);
+    s->next = nullptr;
+    s->prev = nullptr;
+    s->free_list = nullptr;
+    s->bump = reinterpret_cast<char*>(s) + SLAB_HEADER_SIZE;
+    s->size_class = size_class;
+    s->used = 0;
+    s->capacity = static_cast<uint32_t>((SLAB_SIZE - SLAB_HEADER_SIZE) / block_size);
+    s->block_size = static_cast<uint32_t>(block_size);
+    return s;
+}
+
+auto static release_slab(slab* s) -> void {
+    // Keep the address range committed but hand the physical pages back to the kernel
+    xc::platform::advise_memory(reinterpret_cast<char*>(s) + PAGE_SIZE, SLAB_SIZE - PAGE_SIZE, MADV_DONTNEED);
+
+    global_heap.slab_lock.lock();
+    s->next = global_heap.free_slabs;
+    global_heap.free_slabs = s;
+    global_heap.slab_lock.unlock();
+}
+
+// The partial list and slab contents of a class are guarded by its class lock
+auto static link_partial(slab* s) -> void {
+    auto& head = global_heap.classes[s->size_class].partial;
+    s->prev = nullptr;
+    s->next = head;
+    if (head) head->prev = s;
+    head = s;
+}
+
+auto static unlink_partial(slab* s) -> void {
+    auto& head = global_heap.classes[s->size_class].partial;
+    if (s->prev) s->prev->next = s->next;
+    else head = s->next;
+    if (s->next) s->next->prev = s->prev;
+    s->next = nullptr;
+    s->prev = nullptr;
+}
+
+// Pops up to count blocks from the partial slabs of a class onto a list.  Returns how many were taken
+auto static take_blocks(uint32_t size_class, void*& list, uint32_t count) -> uint32_t {
+    auto& class_heap = global_heap.classes[size_class];
+    auto taken = 0u;
+
+    class_heap.lock.lock();
+    while (taken < count) {
+        auto s = class_heap.partial;
+        if (!s) {
+            // Don't hold the class lock across the slab lock and a possible mprotect
+            class_heap.lock.unlock();
+            s = acquire_slab(size_class);
+            class_heap.lock.lock();
+            if (!s) break;
+            link_partial(s);
+        }
+
+        while (taken < count && s->used < s->capacity) {
+            void* block;
+            if (s->free_list) {
+                block = s->free_list;
+                s->free_list = *static_cast<void**>(block);
+            } else {
+                block = s->bump;
+                s->bump += s->block_size;
+            }
+
+            *static_cast<void**>(block) = list;
+            list = block;
+            ++s->used;
+            ++taken;
+        }
+
+        if (s->used == s->capacity) unlink_partial(s);
+    }
+    class_heap.lock.unlock();
+
+    return taken;
+}
+
+// Returns count blocks from the front of a list to their slabs
+auto static return_blocks(uint32_t size_class, void*& list, uint32_t count) -> void {
+    auto& class_heap = global_heap.classes[size_class];
+    slab* empty = nullptr;
+
+    class_heap.lock.lock();
+    for (auto i = 0u; i < count; ++i) {
+        auto const block = list;
+        list = *static_cast<void**>(block);
+
+        auto const s = slab_of(block);
+        auto const was_full = s->used == s->capacity;
+
+        *static_cast<void**>(block) = s->free_list;
+        s->free_list = block;
+        --s->used;
+
+        if (was_full) {
+            link_partial(s);
+        } else if (s->used == 0 && (s->prev || s->next)) {
+            // Keep one empty slab per class around so a single alloc/free pair doesn't thrash
+            unlink_partial(s);
+            s->next = empty;
+            empty = s;
+        }
+    }
+    class_heap.lock.unlock();
+
+    while (empty) {
+        auto const next = empty->next;
+        release_slab(empty);
+        empty = next;
+    }
+}
+
+auto static allocate_small(size_t size) -> void* {
+    auto const size_class = size_class_of(size);
+    auto& m = cache.magazines[size_class];
+
+    if (!m.head) {
+        m.count += take_blocks(size_class, m.head, batch_size_of(size_class));
+        if (!m.head) return nullptr;
+    }
+
+    auto const block = m.head;
+    m.head = *static_cast<void**>(block);
+    --m.count;
+    return block;
+}
+
+auto static free_small(void* ptr) -> void {
+    auto const size_class = slab_of(ptr)->size_class;
+    auto& m = cache.magazines[size_class];
+
+    *static_cast<void**>(ptr) = m.head;
+    m.head = ptr;
+
+    auto const batch = batch_size_of(size_class);
+    if (++m.count > 2 * batch) {
+        return_blocks(size_class, m.head, batch);
+        m.count -= batch;
+    }
+}
+
+// The mapping for a large block of size bytes, or 0 when that doesn't fit a size_t
+auto static large_mapped_size(size_t size) -> size_t {
+    auto mapped_size = size_t{};
+    if (__builtin_add_overflow(size, LARGE_HEADER_SIZE + PAGE_SIZE - 1, &mapped_size)) return 0;
+    return mapped_size & ~(PAGE_SIZE - 1);
+}
+
+auto static allocate_large(size_t size) -> void* {
+    auto const mapped_size = large_mapped_size(size);
+    if (!mapped_size) return nullptr;
+    auto const memory = xc::platform::map_memory(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS);
+    if (memory == MAP_FAILED) return nullptr;
+
+    auto const header = static_cast<large_header*>(memory);
+    header->mapped_size = mapped_size;
+    header->size = size;
+    header->offset = 0;
+    return static_cast<char*>(memory) + LARGE_HEADER_SIZE;
+}
+
+auto static large_header_of(void* ptr) -> large_header* {
+    return reinterpret_cast<large_header*>(static_cast<char*>(ptr) - LARGE_HEADER_SIZE);
+}
+
+// Maps enough to slide the block up to its alignment, then unmaps the whole pages on either side again.  The header
+// still sits right below the block and remembers where the mapping starts
+auto static allocate_large_aligned(size_t size, size_t alignment) -> void* {
+    auto reserved = size_t{};
+    if (__builtin_add_overflow(size, LARGE_HEADER_SIZE + alignment + PAGE_SIZE - 1, &reserved)) return nullptr;
+    reserved &= ~(PAGE_SIZE - 1);
+
+    auto const memory = static_cast<char*>(xc::platform::map_memory(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS));
+    if (memory == MAP_FAILED) return nullptr;
+
+    auto const address = reinterpret_cast<uintptr_t>(memory);
+    auto const ptr = (address + LARGE_HEADER_SIZE + alignment - 1) & ~(alignment - 1);
+    auto const begin = (ptr - LARGE_HEADER_SIZE) & ~(PAGE_SIZE - 1);
+    auto const end = (ptr + size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (begin != address) xc::platform::unmap_memory(memory, begin - address);
+    if (end != address + reserved) xc::platform::unmap_memory(reinterpret_cast<void*>(end), address + reserved - end);
+
+    auto const header = large_header_of(reinterpret_cast<void*>(ptr));
+    header->mapped_size = end - begin;
+    header->size = size;
+    header->offset = ptr - LARGE_HEADER_SIZE - begin;
+    return reinterpret_cast<void*>(ptr);
+}
+
+// Resizes the mapping itself, so the kernel moves page table entries instead of the contents being copied
+auto static reallocate_large(void* ptr, size_t size) -> void* {
+    auto const header = large_header_of(ptr);
+    auto const mapped_size = large_mapped_size(size);
+    if (!mapped_size) return nullptr;
+    if (mapped_size != header->mapped_size) {
+        auto const memory = xc::platform::remap_memory(header, header->mapped_size, mapped_size, MREMAP_MAYMOVE);
+        if (memory == MAP_FAILED) return nullptr;
+        ptr = static_cast<char*>(memory) + LARGE_HEADER_SIZE;
+    }
+
+    auto const moved = large_header_of(ptr);
+    moved->mapped_size = mapped_size;
+    moved->size = size;
+    return ptr;
+}
+
+auto static usable_size(void* ptr) -> size_t {
+    if (in_heap(ptr)) return slab_of(ptr)->block_size;
+    auto const header = large_header_of(ptr);
+    return header->mapped_size - header->offset - LARGE_HEADER_SIZE;
+}
+
+
+namespace xc::platform {
+    auto flush_allocation_cache() -> void {
+        for (auto size_class = 0u; size_class < SIZE_CLASS_COUNT; ++size_class) {
+            auto& m = cache.magazines[size_class];
+            return_blocks(size_class, m.head, m.count);
+            m.count = 0;
+        }
+    }
+}
+
+
+// Virtual Memory //////////////////////////////////////////////////////////////////////////////////////////////////////
+auto static constexpr HUGE_PAGE_SIZE = size_t{2} << 20;
+
+namespace xc::platform {
+    // Reservations are aligned to 2 MiB so committed ranges can be backed by transparent huge pages
+    auto reserve_memory(size_t size) -> void* {
+        size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        auto const memory = map_memory(nullptr, size + HUGE_PAGE_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE);
+        if (memory == MAP_FAILED) return nullptr;
+
+        auto const start = static_cast<char*>(memory);
+        auto const aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(start) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+        if (aligned > start) unmap_memory(start, static_cast<size_t>(aligned - start));
+        unmap_memory(aligned + size, static_cast<size_t>(start + HUGE_PAGE_SIZE - aligned));
+        return aligned;
+    }
+
+    auto commit_memory(void* address, size_t size, memory_flags flags) -> bool {
+        if (!protect_memory(address, size, PROT_READ | PROT_WRITE)) return false;
+        if (flags & memory_flags::huge_pages) advise_memory(address, size, MADV_HUGEPAGE);
+
+        // MADV_POPULATE_WRITE needs Linux 5.14, touch every page on older kernels
+        if ((flags & memory_flags::prefault) && !advise_memory(address, size, MADV_POPULATE_WRITE)) {
+            for (auto offset = size_t{}; offset < size; offset += PAGE_SIZE)
+                static_cast<char volatile*>(address)[offset] = 0;
+        }
+        return true;
+    }
+
+    auto decommit_memory(void* address, size_t size) -> void {
+        advise_memory(address, size, MADV_DONTNEED);
+        protect_memory(address, size, PROT_NONE);
+    }
+
+    auto release_memory(void* address, size_t size) -> void {
+        unmap_memory(address, (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+    }
+}
+
+
+// Telemetry ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(MEMORY_TELEMETRY)
+auto static constexpr TAG_COUNT = static_cast<size_t>(xc::memory_tag::count);
+auto static constexpr CALL_SITE_COUNT = 256u;
+
+struct alignas(64) tag_counters {
+    std::atomic<uint64_t> live_bytes;
+    std::atomic<uint64_t> peak_bytes;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> histogram[xc::platform::MEMORY_HISTOGRAM_BUCKETS];
+};
+
+struct call_site {
+    uintptr_t address;
+    uint64_t count;
+    uint64_t bytes;
+    xc::memory_tag tag;
+};
+
+struct telemetry {
+    tag_counters tags[TAG_COUNT];
+    std::atomic<uint32_t> sampling_interval;
+    xc::spin_lock call_site_lock;
+    call_site call_sites[CALL_SITE_COUNT];   // open addressing on the return address
+    uint64_t dropped_samples;
+};
+
+constinit static telemetry global_telemetry = {};
+constinit static thread_local uint32_t sample_countdown = 0;
+
+auto static histogram_bucket(size_t size) -> uint32_t {
+    if (size <= 16) return 0u;
+    auto const bucket = static_cast<uint32_t>(64 - __builtin_clzll(size - 1)) - 4u;
+    return bucket < xc::platform::MEMORY_HISTOGRAM_BUCKETS ? bucket : xc::platform::MEMORY_HISTOGRAM_BUCKETS - 1u;
+}
+
+auto static sample_call_site(xc::memory_tag tag, size_t size, void* return_address) -> void {
+    auto const address = reinterpret_cast<uintptr_t>(return_address);
+    auto& t = global_telemetry;
+
+    t.call_site_lock.lock();
+    auto index = static_cast<uint32_t>(wyhash(address)) & (CALL_SITE_COUNT - 1u);
+    for (auto probe = 0u; probe < CALL_SITE_COUNT; ++probe, index = (index + 1u) & (CALL_SITE_COUNT - 1u)) {
+        auto& site = t.call_sites[index];
+        if (site.address == address || site.address == 0u) {
+            site.address = address;
+            site.tag = tag;
+            ++site.count;
+            site.bytes += size;
+            t.call_site_lock.unlock();
+            return;
+        }
+    }
+    ++t.dropped_samples;
+    t.call_site_lock.unlock();
+}
+
+auto static record_allocation(xc::memory_tag tag, void* ptr, void* return_address) -> void {
+    if (!ptr) return;
+
+    auto const size = usable_size(ptr);
+    auto& counters = global_telemetry.tags[static_cast<size_t>(tag)];
+    auto const live = counters.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.histogram[histogram_bucket(size)].fetch_add(1, std::memory_order_relaxed);
+
+    auto const interval = global_telemetry.sampling_interval.load(std::memory_order_relaxed);
+    if (interval != 0u && ++sample_countdown >= interval) {
+        sample_countdown = 0u;
+        sample_call_site(tag, size, return_address);
+    }
+}
+
+auto static record_free(xc::memory_tag tag, void* ptr) -> void {
+    if (!ptr) return;
+
+    auto& counters = global_telemetry.tags[static_cast<size_t>(tag)];
+    counters.live_bytes.fetch_sub(usable_size(ptr), std::memory_order_relaxed);
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace xc::platform {
+    auto get_memory_stats(memory_tag tag) -> memory_stats {
+        auto& counters = global_telemetry.tags[static_cast<size_t>(tag)];
+        auto stats = memory_stats{};
+        stats.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+        stats.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+        stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+        stats.frees = counters.frees.load(std::memory_order_relaxed);
+        for (auto i = 0u; i < MEMORY_HISTOGRAM_BUCKETS; ++i)
+            stats.histogram[i] = counters.histogram[i].load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    auto set_allocation_sampling(uint32_t interval) -> void {
+        global_telemetry.sampling_interval.store(interval, std::memory_order_relaxed);
+    }
+
+    auto dump_memory_stats() -> void {
+        char const* tag_names[] = {"untagged", "core", "renderer", "game"};
+        static_assert(count_of(tag_names) == TAG_COUNT);
+
+        for (auto tag = 0u; tag < TAG_COUNT; ++tag) {
+            auto const stats = get_memory_stats(static_cast<memory_tag>(tag));
+            print("%s: live %llu bytes, peak %llu bytes, %llu allocations, %llu frees\n", tag_names[tag],
+                  static_cast<unsigned long long>(stats.live_bytes), static_cast<unsigned long long>(stats.peak_bytes),
+                  static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.frees));
+            for (auto i = 0u; i < MEMORY_HISTOGRAM_BUCKETS; ++i)
+                if (stats.histogram[i]) print("\t<= %llu bytes: %llu\n", 16ull << i, static_cast<unsigned long long>(stats.histogram[i]));
+        }
+
+        // Copy the sampled sites out under the lock, then report the heaviest by bytes
+        auto& t = global_telemetry;
+        call_site sites[CALL_SITE_COUNT];
+        t.call_site_lock.lock();
+        memcpy(sites, t.call_sites, sizeof(sites));
+        auto const dropped = t.dropped_samples;
+        t.call_site_lock.unlock();
+
+        print("hot call sites (%llu samples dropped):\n", static_cast<unsigned long long>(dropped));
+        for (auto rank = 0u; rank < 16u; ++rank) {
+            auto best = CALL_SITE_COUNT;
+            for (auto i = 0u; i < CALL_SITE_COUNT; ++i)
+                if (sites[i].address && (best == CALL_SITE_COUNT || sites[i].bytes > sites[best].bytes)) best = i;
+            if (best == CALL_SITE_COUNT) break;
+
+            print("\t%p %s: %llu samples, %llu bytes\n", reinterpret_cast<void*>(sites[best].address),
+                  tag_names[static_cast<size_t>(sites[best].tag)], static_cast<unsigned long long>(sites[best].count),
+                  static_cast<unsigned long long>(sites[best].bytes));
+            sites[best].address = 0u;
+        }
+    }
+}
+#else
+auto static record_allocation(xc::memory_tag, void*, void*) -> void {}
+auto static record_free(xc::memory_tag, void*) -> void {}
+
+namespace xc::platform {
+    auto get_memory_stats(memory_tag) -> memory_stats { return {}; }
+    auto set_allocation_sampling(uint32_t) -> void {}
+    auto dump_memory_stats() -> void { print("Memory telemetry is disabled, build with ENGINE_MEMORY_TELEMETRY\n"); }
+}
+#endif
+
+
+// Allocation Entry Points /////////////////////////////////////////////////////////////////////////////////////////////
+auto static allocate_block(size_t size) -> void* {
+    return size <= MAX_SMALL_SIZE ? allocate_small(size) : allocate_large(size);
+}
+
+auto static free_block(void* ptr) -> void {
+    if (in_heap(ptr)) {
+        free_small(ptr);
+    } else {
+        auto const header = large_header_of(ptr);
+        xc::platform::unmap_memory(reinterpret_cast<char*>(header) - header->offset, header->mapped_size);
+    }
+}
+
+// Blocks are aligned to the largest power of two dividing their class size, up to the 64 byte slab header, and large
+// blocks to 64 bytes.  Anything beyond that gets a mapping of its own
+auto static allocate_aligned_block(size_t size, size_t alignment) -> void* {
+    if (alignment <= 16) return allocate_block(size);
+    if (alignment <= SLAB_HEADER_SIZE) {
+        if (size > MAX_SMALL_SIZE) return allocate_large(size);
+        for (auto size_class = size_class_of(size < alignment ? alignment : size); size_class < SIZE_CLASS_COUNT; ++size_class) {
+            if (size_of_class(size_class) % alignment == 0) return allocate_small(size_of_class(size_class));
+        }
+    }
+    return allocate_large_aligned(size, alignment);
+}
+
+// Returns nullptr and leaves the block alone on failure
+auto static reallocate_block(void* ptr, size_t size) -> void* {
+    auto const small = in_heap(ptr);
+    if (small && size_class_of(size) == slab_of(ptr)->size_class) return ptr;
+    if (!small && size > MAX_SMALL_SIZE && !large_header_of(ptr)->offset) return reallocate_large(ptr, size);
+
+    auto const new_ptr = allocate_block(size);
+    if (!new_ptr) return nullptr;
+
+    auto const old_size = usable_size(ptr);
+    memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    free_block(ptr);
+    return new_ptr;
+}
+
+namespace xc {
+    auto allocate(size_t size, memory_tag tag) -> void* {
+        auto const ptr = allocate_block(size);
+        record_allocation(tag, ptr, __builtin_return_address(0));
+        return ptr;
+    }
+
+    auto deallocate(void* ptr, memory_tag tag) -> void {
+        if (!ptr) return;
+        record_free(tag, ptr);
+        free_block(ptr);
+    }
+
+    auto reallocate(void* ptr, size_t size, memory_tag tag) -> void* {
+        if (!ptr) return allocate(size, tag);
+        if (size == 0) {
+            deallocate(ptr, tag);
+            return nullptr;
+        }
+
+        // On failure the old block is still live, so it's recorded again
+        record_free(tag, ptr);
+        auto const new_ptr = reallocate_block(ptr, size);
+        record_allocation(tag, new_ptr ? new_ptr : ptr, __builtin_return_address(0));
+        return new_ptr;
+    }
+}
+
+
+// C Runtime ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Every libc allocation function is replaced so libc never frees a block it didn't allocate (or the other way around).
+// Failures set errno like libc's would.  Only libc's callers reach these, on threads libc set up, and its errno is
+// weak so the engine still links where nothing pulls libc in
+extern "C" __attribute__((weak)) auto __errno_location() noexcept -> int*;
+
+auto static fail(int error) -> void* {
+    if (__errno_location) *__errno_location() = error;
+    return nullptr;
+}
+
+extern "C" {
+auto malloc(size_t size) -> void* {
+    auto const ptr = allocate_block(size);
+    if (!ptr) return fail(ENOMEM);
+    record_allocation(xc::memory_tag::untagged, ptr, __builtin_return_address(0));
+    return ptr;
+}
+
+auto free(void* ptr) -> void {
+    if (!ptr) return;
+    record_free(xc::memory_tag::untagged, ptr);
+    free_block(ptr);
+}
+
+auto calloc(size_t count, size_t size) -> void* {
+    auto total = size_t{};
+    if (__builtin_mul_overflow(count, size, &total)) return fail(ENOMEM);
+
+    // Fresh mappings are already zero
+    auto const ptr = allocate_block(total);
+    if (!ptr) return fail(ENOMEM);
+    if (ptr && total <= MAX_SMALL_SIZE) memset(ptr, 0, total);
+    record_allocation(xc::memory_tag::untagged, ptr, __builtin_return_address(0));
+    return ptr;
+}
+
+auto realloc(void* ptr, size_t size) -> void* {
+    if (!ptr) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+
+    record_free(xc::memory_tag::untagged, ptr);
+    auto const new_ptr = reallocate_block(ptr, size);
+    record_allocation(xc::memory_tag::untagged, new_ptr ? new_ptr : ptr, __builtin_return_address(0));
+    return new_ptr ? new_ptr : fail(ENOMEM);
+}
+
+auto static allocate_untagged_aligned(size_t alignment, size_t size, void* return_address) -> void* {
+    if (!alignment || (alignment & (alignment - 1))) return fail(EINVAL);
+    auto const ptr = allocate_aligned_block(size, alignment);
+    if (!ptr) return fail(ENOMEM);
+    record_allocation(xc::memory_tag::untagged, ptr, return_address);
+    return ptr;
+}
+
+auto posix_memalign(void** result, size_t alignment, size_t size) -> int {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1))) return EINVAL;
+    // Reports through the result, leaving errno alone
+    auto const ptr = allocate_aligned_block(size, alignment);
+    if (!ptr) return ENOMEM;
+    record_allocation(xc::memory_tag::untagged, ptr, __builtin_return_address(0));
+    *result = ptr;
+    return 0;
+}
+
+auto aligned_alloc(size_t alignment, size_t size) -> void* {
+    return allocate_untagged_aligned(alignment, size, __builtin_return_address(0));
+}
+
+auto memalign(size_t alignment, size_t size) -> void* {
+    return allocate_untagged_aligned(alignment, size, __builtin_return_address(0));
+}
+
+auto valloc(size_t size) -> void* {
+    return allocate_untagged_aligned(PAGE_SIZE, size, __builtin_return_address(0));
+}
+
+auto pvalloc(size_t size) -> void* {
+    if (size > ~size_t{} - PAGE_SIZE) return fail(ENOMEM);
+    return allocate_untagged_aligned(PAGE_SIZE, (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), __builtin_return_address(0));
+}
+
+auto malloc_usable_size(void* ptr) -> size_t {
+    return ptr ? usable_size(ptr) : 0;
+}
+}
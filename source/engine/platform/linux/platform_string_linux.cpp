@@ -0,0 +1,360 @@
+#include <engine/platform/platform_system.h>
+#include <engine/core/cpu.h>
+
+#include <immintrin.h>
+
+// Memory Functions ////////////////////////////////////////////////////////////////////////////////////////////////////
+// memcpy, memmove, memset and memcmp come in SSE2 and AVX2 flavours.  The exported symbols jump through a table that
+// is filled in from cpuid on first use (or by resolve_memory_functions() at startup).  SSE2 is the x86-64 baseline so
+// it doubles as the fallback.
+//
+// Sizes up to two vectors are handled with overlapping loads and stores from both ends, which also makes them safe for
+// memmove.  Larger copies align the destination and stream whole vectors, switching to non-temporal stores for copies
+// too big to stay in cache.
+using memcpy_function = void* (*)(void*, void const*, size_t);
+using memset_function = void* (*)(void*, int, size_t);
+using memcmp_function = int (*)(void const*, void const*, size_t);
+
+auto static constexpr NON_TEMPORAL_THRESHOLD = size_t{4} << 20;
+
+// Loads and stores of 1 to 8 bytes at any alignment
+template<typename T> auto static load(void const* p) -> T { T v; __builtin_memcpy(&v, p, sizeof(T)); return v; }
+template<typename T> auto static store(void* p, T v) -> void { __builtin_memcpy(p, &v, sizeof(T)); }
+
+// Copies up to 16 bytes.  Everything is loaded before anything is stored
+auto static copy_small(char* d, char const* s, size_t n) -> void {
+    if (n >= 8) {
+        auto const a = load<uint64_t>(s), b = load<uint64_t>(s + n - 8);
+        store(d, a); store(d + n - 8, b);
+    } else if (n >= 4) {
+        auto const a = load<uint32_t>(s), b = load<uint32_t>(s + n - 4);
+        store(d, a); store(d + n - 4, b);
+    } else if (n >= 2) {
+        auto const a = load<uint16_t>(s), b = load<uint16_t>(s + n - 2);
+        store(d, a); store(d + n - 2, b);
+    } else if (n == 1) {
+        *d = *s;
+    }
+}
+
+auto static set_small(char* d, uint64_t v, size_t n) -> void {
+    if (n >= 8) {
+        store(d, v); store(d + n - 8, v);
+    } else if (n >= 4) {
+        store(d, static_cast<uint32_t>(v)); store(d + n - 4, static_cast<uint32_t>(v));
+    } else if (n >= 2) {
+        store(d, static_cast<uint16_t>(v)); store(d + n - 2, static_cast<uint16_t>(v));
+    } else if (n == 1) {
+        *d = static_cast<char>(v);
+    }
+}
+
+// Compares up to 16 bytes by loading them big endian, so integer order is byte order
+auto static compare_small(unsigned char const* a, unsigned char const* b, size_t n) -> int {
+    if (n >= 8) {
+        auto x = __builtin_bswap64(load<uint64_t>(a)), y = __builtin_bswap64(load<uint64_t>(b));
+        if (x == y) {
+            x = __builtin_bswap64(load<uint64_t>(a + n - 8));
+            y = __builtin_bswap64(load<uint64_t>(b + n - 8));
+        }
+        return x == y ? 0 : x < y ? -1 : 1;
+    }
+    if (n >= 4) {
+        auto const x = (static_cast<uint64_t>(__builtin_bswap32(load<uint32_t>(a))) << 32) | __builtin_bswap32(load<uint32_t>(a + n - 4));
+        auto const y = (static_cast<uint64_t>(__builtin_bswap32(load<uint32_t>(b))) << 32) | __builtin_bswap32(load<uint32_t>(b + n - 4));
+        return x == y ? 0 : x < y ? -1 : 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+
+// SSE2 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto static memmove_sse2(void* dest, void const* src, size_t n) -> void* {
+    auto const d = static_cast<char*>(dest);
+    auto const s = static_cast<char const*>(src);
+
+    if (n <= 16) {
+        copy_small(d, s, n);
+    } else if (n <= 32) {
+        auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s));
+        auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + n - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + n - 16), b);
+    } else if (static_cast<size_t>(d - s) >= n) {
+        // Forward: every source block is read before the stores that could overlap it
+        auto const tail = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + n - 16));
+        size_t i = 0;
+        for (; i + 16 < n; i += 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + n - 16), tail);
+    } else {
+        // Backward, for a destination overlapping the end of the source
+        auto const head = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s));
+        size_t i = n;
+        for (; i > 16; i -= 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i - 16), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + i - 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), head);
+    }
+    return dest;
+}
+
+auto static memcpy_sse2(void* dest, void const* src, size_t n) -> void* {
+    if (n <= 64) return memmove_sse2(dest, src, n);
+
+    auto d = static_cast<char*>(dest);
+    auto s = static_cast<char const*>(src);
+    auto const end = d + n;
+    auto const tail = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + n - 16));
+
+    // Unaligned head, then aligned stores from the next 16 byte boundary
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s)));
+    auto const skip = 16 - (reinterpret_cast<uintptr_t>(d) & 15);
+    d += skip;
+    s += skip;
+
+    if (n >= NON_TEMPORAL_THRESHOLD) {
+        for (; end - d > 64; d += 64, s += 64) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 16)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 32)));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 48)));
+        }
+        _mm_sfence();
+    } else {
+        for (; end - d > 64; d += 64, s += 64) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 16), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 16)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 32), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 32)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 48), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s + 48)));
+        }
+    }
+
+    for (; end - d > 16; d += 16, s += 16)
+        _mm_store_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<__m128i const*>(s)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16), tail);
+    return dest;
+}
+
+auto static memset_sse2(void* dest, int c, size_t n) -> void* {
+    auto d = static_cast<char*>(dest);
+    auto const byte = static_cast<uint8_t>(c);
+
+    if (n <= 16) {
+        set_small(d, byte * 0x0101010101010101ull, n);
+        return dest;
+    }
+
+    auto const v = _mm_set1_epi8(static_cast<char>(byte));
+    auto const end = d + n;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16), v);
+    if (n <= 32) return dest;
+
+    d += 16 - (reinterpret_cast<uintptr_t>(d) & 15);
+    if (n >= NON_TEMPORAL_THRESHOLD) {
+        for (; end - d > 64; d += 64) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), v);
+        }
+        _mm_sfence();
+    } else {
+        for (; end - d > 64; d += 64) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(d), v);
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 16), v);
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 32), v);
+            _mm_store_si128(reinterpret_cast<__m128i*>(d + 48), v);
+        }
+    }
+    for (; end - d > 16; d += 16) _mm_store_si128(reinterpret_cast<__m128i*>(d), v);
+    return dest;
+}
+
+auto static memcmp_sse2(void const* lhs, void const* rhs, size_t n) -> int {
+    auto const a = static_cast<unsigned char const*>(lhs);
+    auto const b = static_cast<unsigned char const*>(rhs);
+    if (n < 16) return compare_small(a, b, n);
+
+    // Check whole vectors, finishing with one that overlaps the previous block
+    for (size_t i = 0;; i += 16) {
+        if (i + 16 > n) i = n - 16;
+        auto const x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i));
+        auto const y = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i));
+        auto const mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) ^ 0xffffu;
+        if (mask) {
+            auto const j = i + static_cast<size_t>(__builtin_ctz(mask));
+            return a[j] < b[j] ? -1 : 1;
+        }
+        if (i + 16 == n) return 0;
+    }
+}
+
+
+// AVX2 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TARGET_AVX2 auto static memmove_avx2(void* dest, void const* src, size_t n) -> void* {
+    auto const d = static_cast<char*>(dest);
+    auto const s = static_cast<char const*>(src);
+
+    if (n <= 32) return memmove_sse2(dest, src, n);
+
+    if (n <= 64) {
+        auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s));
+        auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + n - 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + n - 32), b);
+    } else if (static_cast<size_t>(d - s) >= n) {
+        auto const tail = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + n - 32));
+        size_t i = 0;
+        for (; i + 32 < n; i += 32)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + n - 32), tail);
+    } else {
+        auto const head = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s));
+        size_t i = n;
+        for (; i > 32; i -= 32)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i - 32), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + i - 32)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), head);
+    }
+    return dest;
+}
+
+TARGET_AVX2 auto static memcpy_avx2(void* dest, void const* src, size_t n) -> void* {
+    if (n <= 128) return memmove_avx2(dest, src, n);
+
+    auto d = static_cast<char*>(dest);
+    auto s = static_cast<char const*>(src);
+    auto const end = d + n;
+    auto const tail = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + n - 32));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s)));
+    auto const skip = 32 - (reinterpret_cast<uintptr_t>(d) & 31);
+    d += skip;
+    s += skip;
+
+    if (n >= NON_TEMPORAL_THRESHOLD) {
+        for (; end - d > 128; d += 128, s += 128) {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s)));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 32)));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 64)));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 96)));
+        }
+        _mm_sfence();
+    } else {
+        for (; end - d > 128; d += 128, s += 128) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 32), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 32)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 64), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 64)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 96), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s + 96)));
+        }
+    }
+
+    for (; end - d > 32; d += 32, s += 32)
+        _mm256_store_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32), tail);
+    return dest;
+}
+
+TARGET_AVX2 auto static memset_avx2(void* dest, int c, size_t n) -> void* {
+    if (n <= 32) return memset_sse2(dest, c, n);
+
+    auto d = static_cast<char*>(dest);
+    auto const v = _mm256_set1_epi8(static_cast<char>(c));
+    auto const end = d + n;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32), v);
+    if (n <= 64) return dest;
+
+    d += 32 - (reinterpret_cast<uintptr_t>(d) & 31);
+    if (n >= NON_TEMPORAL_THRESHOLD) {
+        for (; end - d > 128; d += 128) {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), v);
+        }
+        _mm_sfence();
+    } else {
+        for (; end - d > 128; d += 128) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 32), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 64), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(d + 96), v);
+        }
+    }
+    for (; end - d > 32; d += 32) _mm256_store_si256(reinterpret_cast<__m256i*>(d), v);
+    return dest;
+}
+
+TARGET_AVX2 auto static memcmp_avx2(void const* lhs, void const* rhs, size_t n) -> int {
+    if (n < 32) return memcmp_sse2(lhs, rhs, n);
+
+    auto const a = static_cast<unsigned char const*>(lhs);
+    auto const b = static_cast<unsigned char const*>(rhs);
+    for (size_t i = 0;; i += 32) {
+        if (i + 32 > n) i = n - 32;
+        auto const x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+        auto const y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+        auto const mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (mask) {
+            auto const j = i + static_cast<size_t>(__builtin_ctz(mask));
+            return a[j] < b[j] ? -1 : 1;
+        }
+        if (i + 32 == n) return 0;
+    }
+}
+
+
+
+// Dispatch ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto static resolve_memcpy(void* dest, void const* src, size_t n) -> void*;
+auto static resolve_memmove(void* dest, void const* src, size_t n) -> void*;
+auto static resolve_memset(void* dest, int c, size_t n) -> void*;
+auto static resolve_memcmp(void const* lhs, void const* rhs, size_t n) -> int;
+
+constinit static std::atomic<memcpy_function> memcpy_impl = resolve_memcpy;
+constinit static std::atomic<memcpy_function> memmove_impl = resolve_memmove;
+constinit static std::atomic<memset_function> memset_impl = resolve_memset;
+constinit static std::atomic<memcmp_function> memcmp_impl = resolve_memcmp;
+
+namespace xc::platform {
+    // Every thread that races here stores the same pointers, so relaxed ordering is enough
+    auto resolve_memory_functions() -> void {
+        auto const avx2 = cpu_has_avx2();
+        memcpy_impl.store(avx2 ? memcpy_avx2 : memcpy_sse2, std::memory_order_relaxed);
+        memmove_impl.store(avx2 ? memmove_avx2 : memmove_sse2, std::memory_order_relaxed);
+        memset_impl.store(avx2 ? memset_avx2 : memset_sse2, std::memory_order_relaxed);
+        memcmp_impl.store(avx2 ? memcmp_avx2 : memcmp_sse2, std::memory_order_relaxed);
+    }
+}
+
+auto static resolve_memcpy(void* dest, void const* src, size_t n) -> void* {
+    xc::platform::resolve_memory_functions();
+    return memcpy_impl.load(std::memory_order_relaxed)(dest, src, n);
+}
+
+auto static resolve_memmove(void* dest, void const* src, size_t n) -> void* {
+    xc::platform::resolve_memory_functions();
+    return memmove_impl.load(std::memory_order_relaxed)(dest, src, n);
+}
+
+auto static resolve_memset(void* dest, int c, size_t n) -> void* {
+    xc::platform::resolve_memory_functions();
+    return memset_impl.load(std::memory_order_relaxed)(dest, c, n);
+}
+
+auto static resolve_memcmp(void const* lhs, void const* rhs, size_t n) -> int {
+    xc::platform::resolve_memory_functions();
+    return memcmp_impl.load(std::memory_order_relaxed)(lhs, rhs, n);
+}
+
+
+// C Runtime ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+extern "C" {
+auto memcpy(void* dest, void const* src, size_t n) -> void* { return memcpy_impl.load(std::memory_order_relaxed)(dest, src, n); }
+auto memmove(void* dest, void const* src, size_t n) -> void* { return memmove_impl.load(std::memory_order_relaxed)(dest, src, n); }
+auto memset(void* dest, int c, size_t n) -> void* { return memset_impl.load(std::memory_order_relaxed)(dest, c, n); }
+auto memcmp(void const* lhs, void const* rhs, size_t n) -> int { return memcmp_impl.load(std::memory_order_relaxed)(lhs, rhs, n); }
+}
@@ -0,0 +1,49 @@
+#ifndef ENGINE_PLATFORM_LINUX_PLATFORM_SYSCALL_LINUX_H
+#define ENGINE_PLATFORM_LINUX_PLATFORM_SYSCALL_LINUX_H
+
+#include <engine/core/types.h>
+
+#include <sys/syscall.h>
+
+// Raw x86-64 system calls.  The kernel clobbers rcx and r11, arguments go in rdi, rsi, rdx, r10, r8, r9
+namespace xc::platform {
+    auto inline system_call(long number, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0) -> long {
+        long result;
+        register long r10 asm("r10") = a3;
+        register long r8 asm("r8") = a4;
+        register long r9 asm("r9") = a5;
+        asm volatile (
+                "syscall"
+                : "=a"(result)
+                : "a"(number), "D"(a0), "S"(a1), "d"(a2), "r"(r10), "r"(r8), "r"(r9)
+                : "rcx", "r11", "memory"
+                );
+        return result;
+    }
+
+    // Returns MAP_FAILED ((void*)-1) on error, like the libc wrapper
+    auto inline map_memory(void* address, size_t size, int protection, int flags) -> void* {
+        auto const result = system_call(SYS_mmap, reinterpret_cast<long>(address), static_cast<long>(size), protection, flags, -1, 0);
+        return (result < 0 && result > -4096) ? reinterpret_cast<void*>(-1) : reinterpret_cast<void*>(result);
+    }
+
+    // Grows or shrinks a mapping, moving it if it can't be resized in place.  Returns MAP_FAILED on error
+    auto inline remap_memory(void* address, size_t old_size, size_t new_size, int flags) -> void* {
+        auto const result = system_call(SYS_mremap, reinterpret_cast<long>(address), static_cast<long>(old_size), static_cast<long>(new_size), flags);
+        return (result < 0 && result > -4096) ? reinterpret_cast<void*>(-1) : reinterpret_cast<void*>(result);
+    }
+
+    auto inline unmap_memory(void* address, size_t size) -> void {
+        system_call(SYS_munmap, reinterpret_cast<long>(address), static_cast<long>(size));
+    }
+
+    auto inline protect_memory(void* address, size_t size, int protection) -> bool {
+        return system_call(SYS_mprotect, reinterpret_cast<long>(address), static_cast<long>(size), protection) == 0;
+    }
+
+    auto inline advise_memory(void* address, size_t size, int advice) -> bool {
+        return system_call(SYS_madvise, reinterpret_cast<long>(address), static_cast<long>(size), advice) == 0;
+    }
+}
+
+#endif // ENGINE_PLATFORM_LINUX_PLATFORM_SYSCALL_LINUX_H
@@ -1,6 +1,8 @@
 #include <engine/platform/platform_system.h>
+#include <engine/platform/linux/platform_syscall_linux.h>
 
-
+#include <errno.h>
+#include <stdarg.h>
 #include <X11/Xlib.h>
 
 extern "C" void __stack_chk_fail() {}
@@ -8,6 +10,8 @@ extern "C" void __stack_chk_guard() {}
 
 namespace xc::platform {
     auto initialize() -> bool {
+        resolve_memory_functions();
+
         Display *display = XOpenDisplay(nullptr);
         if (!display) {
             //std::cerr << "Error opening display" << std::endl;
@@ -41,111 +45,112 @@ namespace xc::platform {
     auto load_function(void *library, char const *name) -> void * {}
 }
 
-extern "C" {
-#include <sys/mman.h>
-#include <linux/mman.h>
-
-#define MIN_BLOCK_SIZE 4096 // Minimum block size for allocation
-
-typedef struct block {
+// Print ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Without the C runtime there is no vprintf, so this formats itself: the '-' and '0' flags, a width, the h, l, ll and z
+// lengths and the d, i, u, x, X, p, c and s conversions.  Output goes straight to stderr, a buffer at a time
+struct print_buffer {
+    char data[512];
     size_t size;
-    struct block *next;
-} Block;
-
-Block *head = NULL; // Head of the linked list of allocated blocks
-
-void *malloc(size_t size) {
-    // Ensure size is a multiple of the system page size
-    size_t aligned_size = (size + MIN_BLOCK_SIZE - 1) & ~(MIN_BLOCK_SIZE - 1);
-
-    // Allocate memory using mmap system call
-    void *memory;
-    asm volatile (
-            "mov $9, %%rax\n"             // mmap system call number
-            "xor %%rdi, %%rdi\n"          // addr (NULL)
-            "mov %1, %%rsi\n"             // length
-            "mov %2, %%rdx\n"             // prot (PROT_READ | PROT_WRITE)
-            "mov $0x22, %%r10\n"          // flags (MAP_PRIVATE | MAP_ANONYMOUS)
-            "xor %%r8, %%r8\n"            // fd (zeroed)
-            "xor %%r9, %%r9\n"            // offset (zeroed)
-            "syscall\n"                   // invoke the system call
-            "mov %%rax, %0\n"             // save the result
-            : "=r"(memory)
-            : "r"(aligned_size), "r"((unsigned long) (PROT_READ | PROT_WRITE))
-            : "%rax", "%rdi", "%rsi", "%rdx", "%r10", "%r8", "%r9"
-            );
-
-    if (memory == MAP_FAILED)
-        return NULL;
-
-    // Create a new block and add it to the list
-    Block *new_block = (Block *) memory;
-    new_block->size = aligned_size;
-    new_block->next = head;
-    head = new_block;
-
-    // Return the memory region after the block struct
-    return (void *) (new_block + 1);
-}
-
-void free(void *ptr) {
-    if (ptr == NULL)
-        return;
-
-    // Find the block in the list
-    Block *current_block = head;
-    Block *previous_block = NULL;
-    while (current_block != NULL && (void *) (current_block + 1) != ptr) {
-        previous_block = current_block;
-        current_block = current_block->next;
-    }
-
-    // If the block was found, remove it from the list and deallocate memory using munmap
-    if (current_block != NULL) {
-        if (previous_block != NULL)
-            previous_block->next = current_block->next;
-        else
-            head = current_block->next;
-
-        // Deallocate memory using munmap system call
-        asm volatile (
-                "movq $11, %%rax\n"       // munmap system call number
-                "movq %0, %%rdi\n"        // address
-                "movq %1, %%rsi\n"        // size
-                "xor %%rdx, %%rdx\n"      // flags (zeroed)
-                "syscall\n"               // invoke the system call
-                :
-                : "r"(current_block), "r"(current_block->size)
-                : "%rax", "%rdi", "%rsi", "%rdx"
-                );
+};
+
+auto static flush(print_buffer& buffer) -> void {
+    for (auto written = size_t{}; written < buffer.size;) {
+        auto const result = xc::platform::system_call(SYS_write, 2, reinterpret_cast<long>(buffer.data + written), static_cast<long>(buffer.size - written));
+        if (result == -EINTR) continue;
+        if (result <= 0) break;
+        written += static_cast<size_t>(result);
     }
+    buffer.size = 0;
 }
 
-auto memset(void *s, int c, size_t n) -> void* {
-    auto *ptr = reinterpret_cast<unsigned char*>(s);
-    auto value = static_cast<unsigned char>(c);
-
-    for (size_t i = 0; i < n; i++) {
-        *ptr = value;
-        ptr++;
-    }
+auto static put(print_buffer& buffer, char c) -> void {
+    if (buffer.size == sizeof(buffer.data)) flush(buffer);
+    buffer.data[buffer.size++] = c;
+}
 
-    return s;
+auto static pad(print_buffer& buffer, uint32_t length, uint32_t width, char c) -> void {
+    for (; length < width; ++length) put(buffer, c);
 }
 
-auto memcpy(void *dest, const void *src, size_t n) -> void* {
-    auto *dst_ptr = reinterpret_cast<unsigned char*>(dest);
-    auto *src_ptr = reinterpret_cast<const unsigned char*>(src);
+auto static put_number(print_buffer& buffer, unsigned long long value, uint32_t base, bool upper, char const* prefix, uint32_t width, bool left, bool zero) -> void {
+    char digits[24];
+    auto count = 0u;
+    do {
+        auto const digit = static_cast<char>(value % base);
+        digits[count++] = static_cast<char>(digit < 10 ? '0' + digit : (upper ? 'A' : 'a') + digit - 10);
+        value /= base;
+    } while (value);
+
+    auto prefix_length = 0u;
+    while (prefix[prefix_length]) ++prefix_length;
+
+    auto const length = count + prefix_length;
+    if (!left && !zero) pad(buffer, length, width, ' ');
+    for (auto i = 0u; i < prefix_length; ++i) put(buffer, prefix[i]);
+    if (!left && zero) pad(buffer, length, width, '0');
+    while (count) put(buffer, digits[--count]);
+    if (left) pad(buffer, length, width, ' ');
+}
 
-    for (size_t i = 0; i < n; i++) {
-        *dst_ptr = *src_ptr;
-        dst_ptr++;
-        src_ptr++;
-    }
+auto print(const char *format, ...) -> void {
+    va_list args;
+    va_start(args, format);
 
-    return dest;
-}
+    print_buffer buffer;
+    buffer.size = 0;
+    for (auto p = format; *p; ++p) {
+        if (*p != '%') {
+            put(buffer, *p);
+            continue;
+        }
 
-}
+        auto left = false, zero = false;
+        for (; p[1] == '-' || p[1] == '0'; ++p) (p[1] == '-' ? left : zero) = true;
+        auto width = 0u;
+        for (; p[1] >= '0' && p[1] <= '9'; ++p) width = width * 10u + static_cast<uint32_t>(p[1] - '0');
+        auto wide = false;
+        for (; p[1] == 'h' || p[1] == 'l' || p[1] == 'z'; ++p) wide |= p[1] != 'h';
+        if (!*++p) break;
+
+        switch (*p) {
+            case 'd':
+            case 'i': {
+                auto const value = wide ? va_arg(args, long long) : va_arg(args, int);
+                auto const magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+                put_number(buffer, magnitude, 10u, false, value < 0 ? "-" : "", width, left, zero);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                auto const value = wide ? va_arg(args, unsigned long long) : va_arg(args, unsigned int);
+                put_number(buffer, value, *p == 'u' ? 10u : 16u, *p == 'X', "", width, left, zero);
+                break;
+            }
+            case 'p':
+                put_number(buffer, reinterpret_cast<uintptr_t>(va_arg(args, void*)), 16u, false, "0x", width, left, zero);
+                break;
+            case 'c':
+                if (!left) pad(buffer, 1u, width, ' ');
+                put(buffer, static_cast<char>(va_arg(args, int)));
+                if (left) pad(buffer, 1u, width, ' ');
+                break;
+            case 's': {
+                auto string = va_arg(args, char const*);
+                if (!string) string = "(null)";
+                auto length = 0u;
+                while (string[length]) ++length;
+                if (!left) pad(buffer, length, width, ' ');
+                for (auto i = 0u; i < length; ++i) put(buffer, string[i]);
+                if (left) pad(buffer, length, width, ' ');
+                break;
+            }
+            default:
+                put(buffer, '%');
+                if (*p != '%') put(buffer, *p);
+        }
+    }
 
-auto print(const char *format, ...) -> void {}
\ No newline at end of file
+    va_end(args);
+    flush(buffer);
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <engine/platform/platform_system.h>
+#include <engine/core/epoch.h>
+#include <engine/platform/linux/platform_syscall_linux.h>
+
+#include <elf.h>
+#include <linux/futex.h>
+#include <linux/sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+// Futex ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Private futexes skip the shared mapping lookup in the kernel; every word we park on lives in this process.
+namespace xc {
+    auto wait_on_address(std::atomic<uint32_t>& word, uint32_t expected) -> void {
+        platform::system_call(SYS_futex, reinterpret_cast<long>(&word), FUTEX_WAIT_PRIVATE, static_cast<long>(expected), 0);
+    }
+
+    auto wake_on_address(std::atomic<uint32_t>& word, uint32_t count) -> void {
+        auto const waiters = count > 0x7fffffffu ? 0x7fffffff : static_cast<long>(count);
+        platform::system_call(SYS_futex, reinterpret_cast<long>(&word), FUTEX_WAKE_PRIVATE, waiters);
+    }
+}
+
+// Threads /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Without libc there is no pthread_create, so threads are started with a raw clone.  One mapping holds everything a
+// thread owns: a guard page, the stack, then the thread's copy of the executable's TLS block, a minimal TCB and the
+// control block, in that order.  The thread pointer (fs) points at the TCB with the TLS block right below it, which
+// is where the linker's local exec offsets expect it (x86-64 TLS variant II).
+//
+// Only the executable's own TLS is set up.  Our threads never call into libc or other shared libraries, whose TLS
+// lives in blocks only ld.so knows about.
+auto static constexpr PAGE_SIZE = size_t{4096};
+auto static constexpr TCB_SIZE = size_t{64};
+
+struct thread_control {
+    std::atomic<uint32_t> tid;   // cleared and woken by the kernel once the thread is gone (CLONE_CHILD_CLEARTID)
+    size_t mapping_size;
+    void (*function)(void*);
+    void* argument;
+};
+
+// Where the executable's initial TLS image is
+struct tls_image {
+    char const* data;
+    size_t file_size;
+    size_t memory_size;
+    size_t alignment;
+};
+
+// The linker defines this at the ELF header of the executable, which is mapped along with the first segment
+extern "C" char const __ehdr_start[] __attribute__((visibility("hidden")));
+
+// clone(flags, stack, parent_tid, child_tid, tls) returns twice.  The child resumes on the new stack with nothing
+// to return to, so it picks the function and argument left on that stack, calls it and exits the thread
+extern "C" auto clone_thread(unsigned long flags, void* stack, void* parent_tid, void* child_tid, void* tls, void (*function)(void*), void* argument) -> long;
+
+asm(R"(
+    .text
+    .p2align 4
+    .type clone_thread, @function
+clone_thread:
+    mov 8(%rsp), %rax
+    and $-16, %rsi
+    sub $16, %rsi
+    mov %r9, (%rsi)
+    mov %rax, 8(%rsi)
+    mov %rcx, %r10
+    mov $56, %eax
+    syscall
+    test %rax, %rax
+    jnz 1f
+    xor %ebp, %ebp
+    pop %rax
+    pop %rdi
+    call *%rax
+    mov $60, %eax
+    xor %edi, %edi
+    syscall
+    hlt
+1:
+    ret
+    .size clone_thread, .-clone_thread
+)");
+
+auto static find_tls_image() -> tls_image {
+    auto const header = reinterpret_cast<Elf64_Ehdr const*>(__ehdr_start);
+    auto const segments = reinterpret_cast<Elf64_Phdr const*>(__ehdr_start + header->e_phoff);
+
+    // Load bias: where the segment holding the headers was mapped, minus where it was linked
+    auto bias = uintptr_t{};
+    for (auto i = 0u; i < header->e_phnum; ++i) {
+        if (segments[i].p_type == PT_LOAD && segments[i].p_offset == 0) bias = reinterpret_cast<uintptr_t>(__ehdr_start) - segments[i].p_vaddr;
+    }
+
+    for (auto i = 0u; i < header->e_phnum; ++i) {
+        auto const& segment = segments[i];
+        if (segment.p_type != PT_TLS) continue;
+        return {reinterpret_cast<char const*>(bias + segment.p_vaddr), segment.p_filesz, segment.p_memsz, segment.p_align ? segment.p_align : 1};
+    }
+    return {nullptr, 0, 0, 1};
+}
+
+auto static run_thread(void* argument) -> void {
+    auto const control = static_cast<thread_control*>(argument);
+    control->function(control->argument);
+    xc::epoch::release_thread();
+    xc::platform::flush_allocation_cache();
+}
+
+namespace xc::platform {
+    auto create_thread(void (*function)(void*), void* argument, size_t stack_size) -> thread_t {
+        auto const tls = find_tls_image();
+        auto const tls_size = (tls.memory_size + tls.alignment - 1) & ~(tls.alignment - 1);
+        auto const alignment = tls.alignment > TCB_SIZE ? tls.alignment : TCB_SIZE;
+
+        stack_size = (stack_size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        auto const top_size = (tls_size + alignment + TCB_SIZE + sizeof(thread_control) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        auto const mapping_size = PAGE_SIZE + stack_size + top_size;
+
+        auto const memory = static_cast<char*>(map_memory(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK));
+        if (memory == MAP_FAILED) return {};
+        protect_memory(memory, PAGE_SIZE, PROT_NONE);
+
+        auto const end = reinterpret_cast<uintptr_t>(memory + mapping_size);
+        auto const control = reinterpret_cast<thread_control*>(end - sizeof(thread_control));
+        auto const thread_pointer = (reinterpret_cast<uintptr_t>(control) - TCB_SIZE) & ~(alignment - 1);
+        auto const block = reinterpret_cast<char*>(thread_pointer - tls_size);
+
+        // The mapping is zeroed, which already covers .tbss.  The TCB starts with a pointer to itself
+        if (tls.file_size) memcpy(block, tls.data, tls.file_size);
+        *reinterpret_cast<uintptr_t*>(thread_pointer) = thread_pointer;
+
+        control->mapping_size = mapping_size;
+        control->function = function;
+        control->argument = argument;
+        control->tid.store(1u, std::memory_order_relaxed);
+
+        auto const flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD | CLONE_SYSVSEM |
+                           CLONE_SETTLS | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID;
+        auto const result = clone_thread(flags, block, &control->tid, &control->tid, reinterpret_cast<void*>(thread_pointer), run_thread, control);
+        if (result < 0) {
+            unmap_memory(memory, mapping_size);
+            return {};
+        }
+        return {control};
+    }
+
+    auto join_thread(thread_t thread) -> void {
+        auto const control = static_cast<thread_control*>(thread.handle);
+        if (!control) return;
+
+        // The kernel wakes the tid word with a shared futex wake, which a private wait would never see
+        for (auto tid = control->tid.load(std::memory_order_acquire); tid != 0; tid = control->tid.load(std::memory_order_acquire))
+            system_call(SYS_futex, reinterpret_cast<long>(&control->tid), FUTEX_WAIT, static_cast<long>(tid), 0);
+
+        auto const mapping_size = control->mapping_size;
+        unmap_memory(reinterpret_cast<char*>(control) + sizeof(thread_control) - mapping_size, mapping_size);
+    }
+
+    auto yield_thread() -> void { system_call(SYS_sched_yield); }
+
+    // CPUs this process may run on, which is what matters under taskset or a container's cpuset
+    auto processor_count() -> uint32_t {
+        uint64_t mask[16] = {};
+        auto const size = system_call(SYS_sched_getaffinity, 0, sizeof(mask), reinterpret_cast<long>(mask));
+        if (size <= 0) return 1u;
+
+        auto count = 0u;
+        for (auto i = 0u; i < static_cast<size_t>(size) / sizeof(uint64_t); ++i) count += static_cast<uint32_t>(__builtin_popcountll(mask[i]));
+        return count ? count : 1u;
+    }
+
+    auto monotonic_time() -> uint64_t {
+        timespec time{};
+        system_call(SYS_clock_gettime, CLOCK_MONOTONIC, reinterpret_cast<long>(&time));
+        return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000u + static_cast<uint64_t>(time.tv_nsec);
+    }
+}
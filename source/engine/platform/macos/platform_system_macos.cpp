@@ -1,12 +1,23 @@
 #include <engine/platform/platform_system.h>
+#include <engine/core/epoch.h>
 
 #include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/sysctl.h>
 #include <mach/mach.h>
+#include <mach/mach_time.h>
 #include <mach/mach_vm.h>
 #include <objc/objc-runtime.h>
 #include <objc/NSObjCRuntime.h>
 #include <CoreGraphics/CoreGraphics.h>
 
+// Darwin's futex equivalent, as used by libc++ for atomic waits
+#define UL_COMPARE_AND_WAIT 1u
+#define ULF_WAKE_ALL 0x100u
+extern "C" int __ulock_wait(uint32_t operation, void* address, uint64_t value, uint32_t timeout);
+extern "C" int __ulock_wake(uint32_t operation, void* address, uint64_t wake_value);
+
 auto static constexpr WINDOW_TITLE = "Prototype";
 auto static constexpr WINDOW_WIDTH = 1280;
 auto static constexpr WINDOW_HEIGHT = 720;
@@ -104,6 +115,105 @@ namespace xc::platform {
         if (!f) print("Failed to load: %s\n", name);
         return f;
     };
+
+    auto resolve_memory_functions() -> void {}
+
+    auto flush_allocation_cache() -> void {}
+
+    // libSystem is always linked on macOS, so threads come from pthreads.  Its start routine takes a different
+    // signature, so the function and argument travel in a small heap block
+    struct thread_start {
+        void (*function)(void*);
+        void* argument;
+    };
+
+    auto static run_thread(void* parameter) -> void* {
+        auto const start = *static_cast<thread_start*>(parameter);
+        free(parameter);
+        start.function(start.argument);
+        epoch::release_thread();
+        flush_allocation_cache();
+        return nullptr;
+    }
+
+    auto create_thread(void (*function)(void*), void* argument, size_t stack_size) -> thread_t {
+        auto const start = static_cast<thread_start*>(malloc(sizeof(thread_start)));
+        if (!start) return {};
+        *start = {function, argument};
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        pthread_attr_setstacksize(&attributes, (stack_size + vm_page_size - 1) & ~(vm_page_size - 1));
+        pthread_t thread{};
+        auto const result = pthread_create(&thread, &attributes, run_thread, start);
+        pthread_attr_destroy(&attributes);
+        if (result != 0) {
+            free(start);
+            return {};
+        }
+        return {thread};
+    }
+
+    auto join_thread(thread_t thread) -> void {
+        if (thread.handle) pthread_join(static_cast<pthread_t>(thread.handle), nullptr);
+    }
+
+    auto yield_thread() -> void { sched_yield(); }
+
+    auto processor_count() -> uint32_t {
+        auto count = int32_t{};
+        auto size = sizeof(count);
+        if (sysctlbyname("hw.activecpu", &count, &size, nullptr, 0) != 0 || count < 1) return 1u;
+        return static_cast<uint32_t>(count);
+    }
+
+    auto monotonic_time() -> uint64_t {
+        mach_timebase_info_data_t timebase{};
+        mach_timebase_info(&timebase);
+        return mach_absolute_time() * timebase.numer / timebase.denom;
+    }
+
+    auto reserve_memory(size_t size) -> void* {
+        mach_vm_address_t address = 0;
+        if (mach_vm_allocate(mach_task_self(), &address, size, VM_FLAGS_ANYWHERE) != KERN_SUCCESS) return nullptr;
+        mach_vm_protect(mach_task_self(), address, size, 0, VM_PROT_NONE);
+        return reinterpret_cast<void*>(address);
+    }
+
+    auto commit_memory(void* address, size_t size, memory_flags flags) -> bool {
+        if (mach_vm_protect(mach_task_self(), reinterpret_cast<mach_vm_address_t>(address), size, 0, VM_PROT_READ | VM_PROT_WRITE) != KERN_SUCCESS) return false;
+        if (flags & memory_flags::prefault) {
+            for (auto offset = size_t{}; offset < size; offset += vm_page_size)
+                static_cast<char volatile*>(address)[offset] = 0;
+        }
+        return true;
+    }
+
+    auto decommit_memory(void* address, size_t size) -> void {
+        mach_vm_behavior_set(mach_task_self(), reinterpret_cast<mach_vm_address_t>(address), size, VM_BEHAVIOR_REUSABLE);
+        mach_vm_protect(mach_task_self(), reinterpret_cast<mach_vm_address_t>(address), size, 0, VM_PROT_NONE);
+    }
+
+    auto release_memory(void* address, size_t size) -> void { mach_vm_deallocate(mach_task_self(), reinterpret_cast<mach_vm_address_t>(address), size); }
+
+    // Telemetry is only recorded by the Linux allocator
+    auto get_memory_stats(memory_tag) -> memory_stats { return {}; }
+    auto set_allocation_sampling(uint32_t) -> void {}
+    auto dump_memory_stats() -> void { print("Memory telemetry is not available on this platform\n"); }
+}
+
+namespace xc {
+    auto allocate(size_t size, memory_tag) -> void* { return malloc(size); }
+    auto deallocate(void* ptr, memory_tag) -> void { free(ptr); }
+    auto reallocate(void* ptr, size_t size, memory_tag) -> void* { return realloc(ptr, size); }
+
+    auto wait_on_address(std::atomic<uint32_t>& word, uint32_t expected) -> void {
+        __ulock_wait(UL_COMPARE_AND_WAIT, &word, expected, 0);
+    }
+
+    auto wake_on_address(std::atomic<uint32_t>& word, uint32_t count) -> void {
+        __ulock_wake(UL_COMPARE_AND_WAIT | (count == 1u ? 0u : ULF_WAKE_ALL), &word, 0);
+    }
 }
 
 auto malloc(size_t size) -> void * {
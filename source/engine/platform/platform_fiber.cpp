@@ -0,0 +1,123 @@
+#include <engine/platform/platform_fiber.h>
+#include <engine/platform/platform_system.h>
+
+// Context Switch //////////////////////////////////////////////////////////////////////////////////////////////////////
+// xc_switch_fiber pushes the callee saved state, stores the stack pointer through from, loads to and pops the same
+// state back off the new stack.  A fresh fiber's stack is laid out as if it had been switched away from, returning
+// into xc_start_fiber with entry in r12 and its argument in r13.  The Windows version lives in
+// windows/platform_fiber_windows.asm, since MSVC has no inline assembly on x64
+extern "C" auto xc_switch_fiber(void** from, void* to) -> void;
+extern "C" auto xc_start_fiber() -> void;
+
+#if !defined(_WIN32)
+#if defined(__APPLE__)
+#define FIBER_FUNCTION(name) ".globl _" #name "\n.p2align 4\n_" #name ":\n"
+#define FIBER_END(name)
+#else
+#define FIBER_FUNCTION(name) ".globl " #name "\n.hidden " #name "\n.type " #name ", @function\n.p2align 4\n" #name ":\n"
+#define FIBER_END(name) ".size " #name ", .-" #name "\n"
+#endif
+
+asm(".text\n"
+    FIBER_FUNCTION(xc_switch_fiber) R"(
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+    push %r15
+    sub $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    mov %rsp, (%rdi)
+    mov %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    add $8, %rsp
+    pop %r15
+    pop %r14
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+)" FIBER_END(xc_switch_fiber)
+    FIBER_FUNCTION(xc_start_fiber) R"(
+    mov %r13, %rdi
+    call *%r12
+    ud2
+)" FIBER_END(xc_start_fiber));
+
+#undef FIBER_FUNCTION
+#undef FIBER_END
+
+// Saved by xc_switch_fiber from the lowest address up, with the return address last
+struct fiber_frame {
+    uint32_t mxcsr;
+    uint16_t x87_control;
+    uint16_t padding;
+    uint64_t r15, r14, r13, r12, rbx, rbp;
+    uint64_t return_address;
+};
+#else
+struct alignas(16) fiber_frame {
+    uint64_t xmm[20];            // xmm6 to xmm15
+    uint32_t mxcsr;
+    uint16_t x87_control;
+    uint16_t padding[5];
+    uint64_t deallocation_stack, stack_limit, stack_base;
+    uint64_t r15, r14, r13, r12, rsi, rdi, rbx, rbp;
+    uint64_t return_address;
+};
+#endif
+
+// The return into xc_start_fiber leaves the stack pointer 16 byte aligned, ready for its call
+static_assert(sizeof(fiber_frame) % 16 == 0);
+
+namespace xc::platform {
+    auto make_fiber_context(void* stack, size_t size, void (*entry)(void*), void* argument) -> fiber_context {
+        auto const top = (reinterpret_cast<uintptr_t>(stack) + size) & ~uintptr_t{15};
+        auto const frame = reinterpret_cast<fiber_frame*>(top - sizeof(fiber_frame));
+        *frame = {};
+
+        // Default rounding with every floating point exception masked
+        frame->mxcsr = 0x1f80u;
+        frame->x87_control = 0x037fu;
+        frame->r12 = reinterpret_cast<uintptr_t>(entry);
+        frame->r13 = reinterpret_cast<uintptr_t>(argument);
+        frame->return_address = reinterpret_cast<uintptr_t>(&xc_start_fiber);
+#if defined(_WIN32)
+        frame->stack_base = top;
+        frame->stack_limit = reinterpret_cast<uintptr_t>(stack);
+        frame->deallocation_stack = reinterpret_cast<uintptr_t>(stack) - FIBER_GUARD_SIZE;
+#endif
+        return {frame};
+    }
+
+    auto switch_fiber(fiber_context& from, fiber_context const& to) -> void { xc_switch_fiber(&from.stack_pointer, to.stack_pointer); }
+}
+
+// Stack Pool //////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace xc::platform {
+    auto fiber_stack_pool::initialize(uint32_t count, size_t stack_size) -> bool {
+        stack_size = (stack_size + FIBER_GUARD_SIZE - 1) & ~(FIBER_GUARD_SIZE - 1);
+        _stride = stack_size + FIBER_GUARD_SIZE;
+        _base = static_cast<char*>(reserve_memory(_stride * count));
+        if (!_base) return false;
+
+        _count = count;
+        for (auto i = 0u; i < count; ++i) {
+            if (commit_memory(stack(i), stack_size)) continue;
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    auto fiber_stack_pool::release() -> void {
+        if (_base) release_memory(_base, _stride * _count);
+        _base = nullptr;
+        _stride = 0u;
+        _count = 0u;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef ENGINE_PLATFORM_PLATFORM_FIBER_H
+#define ENGINE_PLATFORM_PLATFORM_FIBER_H
+
+#include <engine/core/types.h>
+
+// Fibers: stacks that are switched to and from explicitly.  A switch only saves what the calling convention says
+// survives a call (callee saved registers, the SSE and x87 control words, and on Windows the stack bounds in the TEB)
+// on the old stack and loads the same from the new one, so it costs about as much as a function call.  Written in
+// assembly for x86-64 System V and Windows, without ucontext or anything else from the C runtime
+namespace xc::platform {
+    // Everything else a suspended fiber needs is on its stack
+    struct fiber_context {
+        void* stack_pointer;
+    };
+
+    // Starts entry(argument) on [stack, stack + size) at the first switch to it.  entry must never return: it ends by
+    // switching away for good
+    auto make_fiber_context(void* stack, size_t size, void (*entry)(void*), void* argument) -> fiber_context;
+
+    // Saves the calling fiber into from and continues to.  Returns when something switches back to from, possibly on
+    // another thread
+    auto switch_fiber(fiber_context& from, fiber_context const& to) -> void;
+
+    // Stacks of one size out of a single reservation.  Each sits above a guard page that is never committed, so an
+    // overflow faults instead of running into the stack below
+    auto static constexpr FIBER_GUARD_SIZE = size_t{4096};
+
+    class fiber_stack_pool {
+    public:
+        auto initialize(uint32_t count, size_t stack_size) -> bool;
+        auto release() -> void;
+
+        [[nodiscard]] auto stack(uint32_t index) const -> void* { return _base + index * _stride + FIBER_GUARD_SIZE; }
+        [[nodiscard]] auto stack_size() const -> size_t { return _stride - FIBER_GUARD_SIZE; }
+        [[nodiscard]] auto count() const -> uint32_t { return _count; }
+
+    private:
+        char* _base = nullptr;
+        size_t _stride = 0u;
+        uint32_t _count = 0u;
+    };
+}
+
+#endif // ENGINE_PLATFORM_PLATFORM_FIBER_H
@@ -0,0 +1,166 @@
+#include <engine/platform/platform_frame_graph.h>
+#include <engine/platform/platform_system.h>
+#include <engine/core/bitset.h>
+
+auto static constexpr NO_SYSTEM = ~0u;
+
+// Calls f(index) for every set bit, lowest first
+template<typename F> auto static for_each_bit(uint64_t bits, F&& f) -> void {
+    for (; bits; bits &= bits - 1) f(xc::count_trailing_zeros(bits));
+}
+
+namespace xc::platform {
+    auto frame_graph::add_system(frame_system const& system) -> bool {
+        if (_compiled || _count == MAX_SYSTEMS) return false;
+        _systems[_count++] = system;
+        return true;
+    }
+
+    // Systems are added in an order that is valid to run them serially, so edges only point forwards and the index
+    // order is already topological
+    auto frame_graph::compile() -> void {
+        uint64_t ancestors[MAX_SYSTEMS] = {};
+        for (auto j = 0u; j < _count; ++j) {
+            auto const& later = _systems[j];
+            auto direct = uint64_t{};
+            for (auto i = 0u; i < j; ++i) {
+                auto const& earlier = _systems[i];
+                if ((earlier.writes & (later.reads | later.writes)) || (earlier.reads & later.writes)) direct |= uint64_t{1} << i;
+            }
+
+            // An edge from a system that is already an ancestor of another predecessor adds nothing
+            auto implied = uint64_t{};
+            for_each_bit(direct, [&](uint32_t i) {
+                implied |= ancestors[i];
+                ancestors[j] |= ancestors[i] | uint64_t{1} << i;
+            });
+            _predecessors[j] = direct & ~implied;
+            for_each_bit(_predecessors[j], [&](uint32_t i) { _successors[i] |= uint64_t{1} << j; });
+        }
+
+        for (auto i = 0u; i < _count; ++i) _runners[i] = {run_runner, this, nullptr, nullptr};
+        _compiled = true;
+    }
+
+    // Longest chain still ahead of each system, by average time.  Systems never timed count as one nanosecond, which
+    // makes the first frame prefer the longest chains by number of systems
+    auto frame_graph::prioritize() -> void {
+        uint64_t chain[MAX_SYSTEMS];
+        for (auto i = _count; i-- > 0;) {
+            auto longest = uint64_t{};
+            for_each_bit(_successors[i], [&](uint32_t s) { longest = chain[s] > longest ? chain[s] : longest; });
+            chain[i] = (_average[i] ? _average[i] : 1u) + longest;
+        }
+
+        // Insertion sort, stable so ties keep the order systems were added in
+        for (auto i = 0u; i < _count; ++i) {
+            auto j = i;
+            for (; j > 0 && chain[_order[j - 1]] < chain[i]; --j) _order[j] = _order[j - 1];
+            _order[j] = static_cast<uint8_t>(i);
+        }
+        for (auto r = 0u; r < _count; ++r) _rank[_order[r]] = static_cast<uint8_t>(r);
+    }
+
+    auto frame_graph::run() -> void {
+        if (!_compiled) compile();
+        if (!_count) return;
+
+        auto const start = monotonic_time();
+        prioritize();
+
+        auto roots = uint64_t{};
+        for (auto i = 0u; i < _count; ++i) {
+            auto const predecessors = popcount(_predecessors[i]);
+            _pending[i].store(predecessors, std::memory_order_relaxed);
+            if (!predecessors) roots |= uint64_t{1} << i;
+        }
+        _remaining.store(_count, std::memory_order_relaxed);
+        _runners_used.store(0u, std::memory_order_relaxed);
+        make_ready(roots);
+
+        // Main thread systems can only run here, but anything else that is ready is fair game too
+        for (;;) {
+            auto const seen = _main_signal.load(std::memory_order_acquire);
+            if (_remaining.load(std::memory_order_acquire) == 0u) break;
+
+            if (auto const system = take_ready(true); system != NO_SYSTEM) {
+                execute(system);
+                continue;
+            }
+
+            _main_sleeping.store(1u, std::memory_order_seq_cst);
+            if (_main_signal.load(std::memory_order_seq_cst) == seen) wait_on_address(_main_signal, seen);
+            _main_sleeping.store(0u, std::memory_order_relaxed);
+        }
+
+        // Runners whose system the main thread took still have to drain before the jobs can be reused
+        wait_for_counter(_runner_counter);
+        _frame_time = monotonic_time() - start;
+
+        uint64_t chain[MAX_SYSTEMS];
+        _critical_path_time = 0u;
+        for (auto i = 0u; i < _count; ++i) {
+            auto longest = uint64_t{};
+            for_each_bit(_predecessors[i], [&](uint32_t p) { longest = chain[p] > longest ? chain[p] : longest; });
+            chain[i] = _time[i] + longest;
+            _critical_path_time = chain[i] > _critical_path_time ? chain[i] : _critical_path_time;
+
+            // Running average over roughly the last eight frames
+            _average[i] = _average[i] ? _average[i] - _average[i] / 8u + _time[i] / 8u : _time[i];
+        }
+    }
+
+    auto frame_graph::run_runner(void* data) -> void {
+        auto& graph = *static_cast<frame_graph*>(data);
+        if (auto const system = graph.take_ready(false); system != NO_SYSTEM) graph.execute(system);
+    }
+
+    // One runner job per system that any worker may run.  A runner takes whatever is most urgent when it starts, not
+    // necessarily the system it was queued for
+    auto frame_graph::make_ready(uint64_t systems) -> void {
+        auto ready = uint64_t{}, main_ready = uint64_t{};
+        for_each_bit(systems, [&](uint32_t s) { (_systems[s].main_thread ? main_ready : ready) |= uint64_t{1} << _rank[s]; });
+
+        _ready_lock.lock();
+        _ready |= ready;
+        _main_ready |= main_ready;
+        _ready_lock.unlock();
+
+        if (ready) {
+            auto const count = popcount(ready);
+            auto const first = _runners_used.fetch_add(count, std::memory_order_relaxed);
+            run_jobs(&_runners[first], count, &_runner_counter);
+        }
+        signal_main();
+    }
+
+    auto frame_graph::take_ready(bool main_thread) -> uint32_t {
+        auto system = NO_SYSTEM;
+        _ready_lock.lock();
+        auto& ready = main_thread && _main_ready ? _main_ready : _ready;
+        if (ready) {
+            system = _order[count_trailing_zeros(ready)];
+            ready &= ready - 1;
+        }
+        _ready_lock.unlock();
+        return system;
+    }
+
+    auto frame_graph::execute(uint32_t system) -> void {
+        auto const start = monotonic_time();
+        _systems[system].function(_systems[system].data);
+        _time[system] = monotonic_time() - start;
+
+        auto ready = uint64_t{};
+        for_each_bit(_successors[system], [&](uint32_t s) {
+            if (_pending[s].fetch_sub(1u, std::memory_order_acq_rel) == 1u) ready |= uint64_t{1} << s;
+        });
+        if (ready) make_ready(ready);
+        if (_remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u) signal_main();
+    }
+
+    auto frame_graph::signal_main() -> void {
+        _main_signal.fetch_add(1u, std::memory_order_seq_cst);
+        if (_main_sleeping.load(std::memory_order_seq_cst)) wake_on_address(_main_signal, 1u);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef ENGINE_PLATFORM_PLATFORM_FRAME_GRAPH_H
+#define ENGINE_PLATFORM_PLATFORM_FRAME_GRAPH_H
+
+#include <engine/core/types.h>
+#include <engine/core/spin_lock.h>
+#include <engine/platform/platform_jobs.h>
+
+// Per frame work as a graph of systems on the job system.  Each system declares the resources it reads and writes as
+// bits of a mask the game defines; compile() orders every pair that conflicts (one writes what the other touches) the
+// way they were added, drops the edges implied by others, and leaves everything else free to run in parallel.  So a
+// frame takes about as long as its longest chain of dependent systems rather than the sum of all of them.
+//
+// Among the systems that are ready, the one heading the longest remaining chain runs first.  Chains are measured in
+// time: every system is timed each frame and the priorities follow a running average.  Systems that must stay on the
+// main thread, such as those pumping window events or owning the GL context, are run by run() itself
+namespace xc::platform {
+    using resource_mask = uint64_t;
+
+    struct frame_system {
+        char const* name;
+        void (*function)(void* data);
+        void* data;
+        resource_mask reads;
+        resource_mask writes;
+        bool main_thread;
+    };
+
+    class frame_graph {
+    public:
+        auto static constexpr MAX_SYSTEMS = 64u;
+
+        // False once full or compiled
+        auto add_system(frame_system const& system) -> bool;
+        auto compile() -> void;
+
+        // One frame, from the thread that called initialize_jobs().  Returns when every system has run
+        auto run() -> void;
+
+        [[nodiscard]] auto system_count() const -> uint32_t { return _count; }
+        [[nodiscard]] auto system(uint32_t index) const -> frame_system const& { return _systems[index]; }
+
+        // Nanoseconds, measured during the last run(): each system, the whole frame, and the longest dependency chain,
+        // which is as short as the frame can get with enough workers
+        [[nodiscard]] auto system_time(uint32_t index) const -> uint64_t { return _time[index]; }
+        [[nodiscard]] auto frame_time() const -> uint64_t { return _frame_time; }
+        [[nodiscard]] auto critical_path_time() const -> uint64_t { return _critical_path_time; }
+
+    private:
+        frame_system _systems[MAX_SYSTEMS] = {};
+        uint64_t _predecessors[MAX_SYSTEMS] = {};
+        uint64_t _successors[MAX_SYSTEMS] = {};
+        uint32_t _count = 0u;
+        bool _compiled = false;
+
+        // Timing, and the priority order it gives: _order[rank] is a system, _rank[system] its place in _order
+        uint64_t _time[MAX_SYSTEMS] = {};
+        uint64_t _average[MAX_SYSTEMS] = {};
+        uint8_t _order[MAX_SYSTEMS] = {};
+        uint8_t _rank[MAX_SYSTEMS] = {};
+        uint64_t _frame_time = 0u;
+        uint64_t _critical_path_time = 0u;
+
+        // Per frame state.  Ready systems are kept as bits by rank, so the lowest set bit is the most urgent
+        std::atomic<uint32_t> _pending[MAX_SYSTEMS] = {};
+        std::atomic<uint32_t> _remaining = 0u;
+        std::atomic<uint32_t> _runners_used = 0u;
+        spin_lock _ready_lock;
+        uint64_t _ready = 0u;
+        uint64_t _main_ready = 0u;
+        job _runners[MAX_SYSTEMS] = {};
+        job_counter _runner_counter;
+
+        // Bumped whenever the main thread may have something to do, which it sleeps on otherwise
+        std::atomic<uint32_t> _main_signal = 0u;
+        std::atomic<uint32_t> _main_sleeping = 0u;
+
+        auto static run_runner(void* data) -> void;
+        auto prioritize() -> void;
+        auto make_ready(uint64_t systems) -> void;
+        auto take_ready(bool main_thread) -> uint32_t;
+        auto execute(uint32_t system) -> void;
+        auto signal_main() -> void;
+    };
+}
+
+#endif // ENGINE_PLATFORM_PLATFORM_FRAME_GRAPH_H
@@ -0,0 +1,166 @@
+#ifndef ENGINE_PLATFORM_PLATFORM_FRAME_PIPELINE_H
+#define ENGINE_PLATFORM_PLATFORM_FRAME_PIPELINE_H
+
+#include <engine/core/types.h>
+#include <engine/core/spin_lock.h>
+#include <engine/core/sync.h>
+#include <engine/platform/platform_system.h>
+
+// Runs the renderer on its own thread, up to depth frames behind the simulation, so a frame costs the slower of the
+// two instead of both.  The simulation fills a snapshot of everything the renderer needs between begin_frame() and
+// end_frame(); the render thread then draws from it while the next frame is simulated into another one.  There are
+// depth + 1 snapshots: begin_frame() blocks while all of them are queued or being drawn.
+//
+// Each frame is timed from begin_frame() to the end of its render, which is the latency between sampling input and
+// submitting the image it affects; every extra frame of depth can add a frame to it.  Depth 0 renders inline in
+// end_frame(), serial as before, with the same accounting.
+//
+// Snapshots must not point at anything the simulation changes while they are in flight.  They may point into
+// frame_memory, which keeps a frame's allocations for one more frame and no longer, so depth is capped at 1.  Call
+// frame_memory.begin_frame() after begin_frame() returns: the wait for a free snapshot is what guarantees the frame
+// whose arena it resets has finished rendering.  The render thread reads those allocations but must not allocate from
+// frame_memory itself, which isn't synchronized.  On Linux threads can't call into shared libraries (see
+// platform_thread_linux.cpp), which rules out a renderer that calls a GL or Vulkan driver there; use depth 0
+namespace xc::platform {
+    struct frame_timing {
+        uint64_t simulate;           // begin_frame() to end_frame()
+        uint64_t simulate_wait;      // begin_frame() waiting for a free snapshot, because the renderer fell behind
+        uint64_t queued;             // published until the renderer started on it
+        uint64_t render;
+        uint64_t latency;            // begin_frame() to the end of its render
+    };
+
+    template<typename Snapshot> class frame_pipeline {
+    public:
+        // frame_memory's lifetime; deeper would need storage per snapshot
+        auto static constexpr MAX_DEPTH = 1u;
+
+        // begin and end run on the render thread around all rendering, for taking over a graphics context; either
+        // may be null
+        struct renderer {
+            void (*begin)(void* data);
+            void (*render)(Snapshot const& snapshot, void* data);
+            void (*end)(void* data);
+            void* data;
+        };
+
+        auto start(uint32_t depth, renderer const& r) -> bool {
+            _depth = depth < MAX_DEPTH ? depth : MAX_DEPTH;
+            _renderer = r;
+            if (!_depth) {
+                if (_renderer.begin) _renderer.begin(_renderer.data);
+                return true;
+            }
+
+            _free.release(_depth + 1u);
+            _thread = create_thread(run_renderer, this);
+            return _thread.handle != nullptr;
+        }
+
+        // Renders whatever is still queued, then ends the render thread
+        auto stop() -> void {
+            if (!_depth) {
+                if (_renderer.end) _renderer.end(_renderer.data);
+                return;
+            }
+
+            // One permit more than there are frames, which the render thread reads as the end
+            _filled.release();
+            join_thread(_thread);
+            _thread = {};
+        }
+
+        auto begin_frame() -> Snapshot& {
+            auto const start = monotonic_time();
+            if (_depth) _free.acquire();
+
+            auto& s = slot(_written.load(std::memory_order_relaxed));
+            s.begin = monotonic_time();
+            s.wait = s.begin - start;
+            return s.snapshot;
+        }
+
+        // The snapshot being filled, between begin_frame() and end_frame()
+        auto current() -> Snapshot& { return slot(_written.load(std::memory_order_relaxed)).snapshot; }
+
+        auto end_frame() -> void {
+            auto const written = _written.load(std::memory_order_relaxed);
+            auto& s = slot(written);
+            s.published = monotonic_time();
+            _written.store(written + 1u, std::memory_order_release);
+
+            if (_depth) {
+                _filled.release();
+                return;
+            }
+            render(s);
+            _rendered.store(written + 1u, std::memory_order_release);
+        }
+
+        [[nodiscard]] auto depth() const -> uint32_t { return _depth; }
+
+        // Published but not rendered yet, including the one being rendered
+        [[nodiscard]] auto frames_in_flight() const -> uint32_t {
+            return _written.load(std::memory_order_acquire) - _rendered.load(std::memory_order_acquire);
+        }
+
+        // Of the last frame rendered
+        [[nodiscard]] auto last_timing() -> frame_timing {
+            spin_lock_scope scope{_timing_lock};
+            return _timing;
+        }
+
+    private:
+        struct snapshot_slot {
+            Snapshot snapshot;
+            uint64_t begin;
+            uint64_t wait;
+            uint64_t published;
+        };
+
+        snapshot_slot _slots[MAX_DEPTH + 1u] = {};
+        uint32_t _depth = 0u;
+        renderer _renderer = {};
+        thread_t _thread = {};
+
+        // Frames published and rendered, counting from start()
+        std::atomic<uint32_t> _written = 0u;
+        std::atomic<uint32_t> _rendered = 0u;
+        semaphore _free;
+        semaphore _filled;
+
+        spin_lock _timing_lock;
+        frame_timing _timing = {};
+
+        auto slot(uint32_t frame) -> snapshot_slot& { return _slots[frame % (_depth + 1u)]; }
+
+        auto render(snapshot_slot& s) -> void {
+            auto const begin = monotonic_time();
+            _renderer.render(s.snapshot, _renderer.data);
+            auto const end = monotonic_time();
+
+            auto const timing = frame_timing{s.published - s.begin, s.wait, begin - s.published, end - begin, end - s.begin};
+            spin_lock_scope scope{_timing_lock};
+            _timing = timing;
+        }
+
+        auto static run_renderer(void* data) -> void {
+            auto& self = *static_cast<frame_pipeline*>(data);
+            if (self._renderer.begin) self._renderer.begin(self._renderer.data);
+
+            for (;;) {
+                self._filled.acquire();
+                auto const rendered = self._rendered.load(std::memory_order_relaxed);
+                if (rendered == self._written.load(std::memory_order_acquire)) break;
+
+                self.render(self.slot(rendered));
+                self._rendered.store(rendered + 1u, std::memory_order_release);
+                self._free.release();
+            }
+
+            if (self._renderer.end) self._renderer.end(self._renderer.data);
+        }
+    };
+}
+
+#endif // ENGINE_PLATFORM_PLATFORM_FRAME_PIPELINE_H
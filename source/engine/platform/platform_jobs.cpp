@@ -0,0 +1,420 @@
+#include <engine/platform/platform_jobs.h>
+#include <engine/platform/platform_fiber.h>
+#include <engine/platform/platform_system.h>
+#include <engine/core/epoch.h>
+#include <engine/core/ring_buffer.h>
+#include <engine/core/work_deque.h>
+
+// Job System //////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto static constexpr MAX_WORKERS = 256u;
+auto static constexpr DEQUE_CAPACITY = 4096u;
+auto static constexpr INJECTED_CAPACITY = 4096u;
+auto static constexpr IDLE_SPINS = 64u;
+auto static constexpr NO_WORKER = ~0u;
+
+// Any worker may read a concurrent_hash, which claims an epoch slot per thread
+static_assert(MAX_WORKERS < xc::epoch::MAX_THREADS, "epoch slots run out before workers do");
+
+// Fibers move between threads, so which worker we are on has to be read again after every switch.  Going through a
+// call the compiler can't see into keeps it from reusing a thread local address it worked out before the switch
+#if defined(_MSC_VER)
+#define THREAD_LOCAL_ACCESS __declspec(noinline)
+#elif defined(__clang__)
+#define THREAD_LOCAL_ACCESS __attribute__((noinline))
+#else
+#define THREAD_LOCAL_ACCESS __attribute__((noipa))
+#endif
+
+struct xc::platform::job_fiber {
+    fiber_context context;
+    job_fiber* next;             // free list, resume queue or the wait list of a counter
+    uint32_t pinned;             // worker whose thread stack this is, NO_WORKER for pooled fibers
+};
+
+struct alignas(xc::CACHE_LINE_SIZE) worker {
+    xc::work_deque<xc::platform::job, xc::memory_tag::core> deque;
+    xc::platform::thread_t thread;
+    uint32_t index;
+    uint32_t random;
+
+    // The thread's own stack, and what runs on the thread right now
+    xc::platform::job_fiber thread_fiber;
+    xc::platform::job_fiber* running;
+
+    // Set once the counter thread_fiber waits on is done; only this worker may resume it
+    std::atomic<xc::platform::job_fiber*> pinned_ready;
+
+    // Left for the far side of the next switch, when the fiber we switched from is off its stack
+    xc::platform::job_fiber* retired;
+    xc::spin_lock* unlock;
+};
+
+struct job_system {
+    worker workers[MAX_WORKERS];
+    uint32_t worker_count;
+    xc::mpmc_ring_buffer<xc::platform::job*, xc::memory_tag::core> injected;
+
+    xc::platform::fiber_stack_pool stacks;
+    xc::platform::job_fiber* fibers;
+    xc::spin_lock fiber_lock;    // guards the two lists below
+    xc::platform::job_fiber* free_fibers;
+    xc::platform::job_fiber* resumed_tail;
+    std::atomic<xc::platform::job_fiber*> resumed_head;
+
+    // Eventcount for parked workers: scheduling bumps the epoch, and wakes someone if anyone is parked
+    alignas(xc::CACHE_LINE_SIZE) std::atomic<uint32_t> epoch;
+    std::atomic<uint32_t> sleepers;
+    std::atomic<bool> stopping;
+};
+
+constinit static job_system scheduler = {};
+constinit static thread_local uint32_t current_worker = NO_WORKER;
+
+namespace xc::platform {
+    auto finish_job(job_counter& counter) -> void;
+}
+
+THREAD_LOCAL_ACCESS auto static worker_index() -> uint32_t { return current_worker; }
+
+auto static find_job(worker& self) -> xc::platform::job* {
+    if (auto const job = self.deque.pop()) return job;
+
+    xc::platform::job* job = nullptr;
+    if (scheduler.injected.pop(job)) return job;
+
+    // Start at a random victim so thieves spread out instead of all hitting worker 0
+    self.random ^= self.random << 13;
+    self.random ^= self.random >> 17;
+    self.random ^= self.random << 5;
+    auto const count = scheduler.worker_count;
+    for (auto i = 0u, victim = self.random % count; i < count; ++i, victim = victim + 1 == count ? 0 : victim + 1) {
+        if (victim == self.index) continue;
+        if ((job = scheduler.workers[victim].deque.steal())) return job;
+    }
+    return nullptr;
+}
+
+auto static notify(uint32_t count) -> void {
+    scheduler.epoch.fetch_add(1u, std::memory_order_seq_cst);
+    auto const sleepers = scheduler.sleepers.load(std::memory_order_seq_cst);
+    if (sleepers) xc::wake_on_address(scheduler.epoch, count < sleepers ? count : sleepers);
+}
+
+// The job may be gone once it has run if nothing counts it
+auto static execute(xc::platform::job* job) -> void {
+    auto const counter = job->counter;
+    job->function(job->data);
+    if (counter) xc::platform::finish_job(*counter);
+}
+
+// Pushes without notifying.  Falls back to running the job inline when the queue is full
+auto static push(xc::platform::job* job) -> void {
+    auto const index = worker_index();
+    auto const pushed = index != NO_WORKER ? scheduler.workers[index].deque.push(job) : scheduler.injected.push(job);
+    if (!pushed) execute(job);
+}
+
+// Fibers //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto static run_fiber(void*) -> void;
+
+auto static take_fiber() -> xc::platform::job_fiber* {
+    scheduler.fiber_lock.lock();
+    auto const fiber = scheduler.free_fibers;
+    if (fiber) scheduler.free_fibers = fiber->next;
+    scheduler.fiber_lock.unlock();
+    if (!fiber) return nullptr;
+
+    auto const index = static_cast<uint32_t>(fiber - scheduler.fibers);
+    fiber->context = xc::platform::make_fiber_context(scheduler.stacks.stack(index), scheduler.stacks.stack_size(), run_fiber, nullptr);
+    return fiber;
+}
+
+// Ready to continue: the thread stack this worker was waiting on, or any pooled fiber whose counter is done
+auto static take_ready_fiber(worker& self) -> xc::platform::job_fiber* {
+    if (self.pinned_ready.load(std::memory_order_relaxed)) return self.pinned_ready.exchange(nullptr, std::memory_order_acquire);
+    if (!scheduler.resumed_head.load(std::memory_order_relaxed)) return nullptr;
+
+    scheduler.fiber_lock.lock();
+    auto const fiber = scheduler.resumed_head.load(std::memory_order_relaxed);
+    if (fiber) {
+        scheduler.resumed_head.store(fiber->next, std::memory_order_relaxed);
+        if (!fiber->next) scheduler.resumed_tail = nullptr;
+    }
+    scheduler.fiber_lock.unlock();
+    return fiber;
+}
+
+auto static has_ready_fiber(worker const& self) -> bool {
+    return self.pinned_ready.load(std::memory_order_relaxed) || scheduler.resumed_head.load(std::memory_order_relaxed);
+}
+
+// Queues fibers whose counter reached zero.  Thread stacks are handed to their own worker, and since we can't tell
+// which parked thread that is, everyone gets woken for them
+auto static resume_fibers(xc::platform::job_fiber* fibers) -> void {
+    auto count = 0u;
+    auto pinned = false;
+    while (fibers) {
+        auto const fiber = fibers;
+        fibers = fiber->next;
+        fiber->next = nullptr;
+        ++count;
+
+        if (fiber->pinned != NO_WORKER) {
+            scheduler.workers[fiber->pinned].pinned_ready.store(fiber, std::memory_order_release);
+            pinned = true;
+            continue;
+        }
+
+        scheduler.fiber_lock.lock();
+        if (scheduler.resumed_tail) scheduler.resumed_tail->next = fiber;
+        else scheduler.resumed_head.store(fiber, std::memory_order_relaxed);
+        scheduler.resumed_tail = fiber;
+        scheduler.fiber_lock.unlock();
+    }
+    notify(pinned ? ~0u : count);
+}
+
+// Runs what the fiber we came from left behind: returning it to the pool if it is done for good, or releasing the
+// lock of the counter it now waits on
+auto static complete_switch() -> void {
+    auto& self = scheduler.workers[worker_index()];
+    if (auto const retired = self.retired) {
+        self.retired = nullptr;
+        scheduler.fiber_lock.lock();
+        retired->next = scheduler.free_fibers;
+        scheduler.free_fibers = retired;
+        scheduler.fiber_lock.unlock();
+    }
+    if (auto const lock = self.unlock) {
+        self.unlock = nullptr;
+        lock->unlock();
+    }
+}
+
+// Never returns when retire is the running fiber
+auto static switch_to(worker& self, xc::platform::job_fiber* target, xc::platform::job_fiber* retire, xc::spin_lock* unlock) -> void {
+    auto const current = self.running;
+    self.running = target;
+    self.retired = retire;
+    self.unlock = unlock;
+    xc::platform::switch_fiber(current->context, target->context);
+    complete_switch();
+}
+
+// Scheduling loop.  It runs jobs on its own stack, so it moves to another thread whenever one of them waits and is
+// resumed elsewhere.  Picking up a ready fiber, or leaving at shutdown, ends this one
+auto static run_fiber(void*) -> void {
+    complete_switch();
+    for (;;) {
+        auto& self = scheduler.workers[worker_index()];
+        if (self.index != 0 && scheduler.stopping.load(std::memory_order_acquire)) switch_to(self, &self.thread_fiber, self.running, nullptr);
+        if (auto const fiber = take_ready_fiber(self)) switch_to(self, fiber, self.running, nullptr);
+
+        auto job = find_job(self);
+        for (auto spin = 0u; !job && spin < IDLE_SPINS && !has_ready_fiber(self); ++spin) {
+            CPU_PAUSE();
+            job = find_job(self);
+        }
+
+        if (!job && !has_ready_fiber(self)) {
+            // Read the epoch before the last look, so anything scheduled after it changes the epoch and the wait
+            // returns at once
+            auto const epoch = scheduler.epoch.load(std::memory_order_seq_cst);
+            scheduler.sleepers.fetch_add(1u, std::memory_order_seq_cst);
+            job = find_job(self);
+            if (!job && !has_ready_fiber(self) && !scheduler.stopping.load(std::memory_order_seq_cst)) xc::wait_on_address(scheduler.epoch, epoch);
+            scheduler.sleepers.fetch_sub(1u, std::memory_order_relaxed);
+        }
+
+        if (job) execute(job);
+    }
+}
+
+// Worker threads only keep their own stack to come back to at shutdown
+auto static run_worker(void* argument) -> void {
+    auto& self = *static_cast<worker*>(argument);
+    current_worker = self.index;
+    self.running = &self.thread_fiber;
+
+    auto fiber = take_fiber();
+    while (!fiber) {
+        xc::platform::yield_thread();
+        fiber = take_fiber();
+    }
+    switch_to(self, fiber, nullptr, nullptr);
+}
+
+namespace xc::platform {
+    // The last decrement happens under the counter's lock, so a waiter that takes the lock after seeing zero knows
+    // nobody touches the counter any more and may let it go out of scope
+    auto finish_job(job_counter& counter) -> void {
+        auto pending = counter._pending.load(std::memory_order_relaxed);
+        while (pending > 1u) {
+            if (counter._pending.compare_exchange_weak(pending, pending - 1u, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+        }
+
+        counter._lock.lock();
+        if (counter._pending.fetch_sub(1u, std::memory_order_seq_cst) != 1u) {
+            counter._lock.unlock();
+            return;
+        }
+        auto continuations = counter._continuations;
+        auto const fibers = counter._fibers;
+        counter._continuations = nullptr;
+        counter._fibers = nullptr;
+        auto const waiters = counter._waiters.load(std::memory_order_seq_cst);
+        counter._lock.unlock();
+
+        // Waking an address that has gone out of scope is harmless
+        if (waiters) wake_on_address(counter._pending, ~0u);
+        if (fibers) resume_fibers(fibers);
+
+        auto scheduled = 0u;
+        while (continuations) {
+            auto const next = continuations->next;
+            push(continuations);
+            continuations = next;
+            ++scheduled;
+        }
+        if (scheduled) notify(scheduled);
+    }
+
+    auto initialize_jobs(uint32_t worker_count) -> bool {
+        if (worker_count == 0) worker_count = processor_count() - 1;
+        if (worker_count > MAX_WORKERS - 1) worker_count = MAX_WORKERS - 1;
+
+        scheduler.worker_count = worker_count + 1;
+        scheduler.stopping.store(false, std::memory_order_relaxed);
+        if (!scheduler.injected.initialize(INJECTED_CAPACITY)) return false;
+        for (auto i = 0u; i < scheduler.worker_count; ++i) {
+            auto& w = scheduler.workers[i];
+            if (!w.deque.initialize(DEQUE_CAPACITY)) return false;
+            w.index = i;
+            w.random = static_cast<uint32_t>(wyhash(i + 1));
+            w.thread_fiber = {{}, nullptr, i};
+            w.running = &w.thread_fiber;
+        }
+
+        auto const fiber_count = scheduler.worker_count * FIBERS_PER_WORKER;
+        if (!scheduler.stacks.initialize(fiber_count, JOB_STACK_SIZE)) return false;
+        scheduler.fibers = static_cast<job_fiber*>(allocate(fiber_count * sizeof(job_fiber), memory_tag::core));
+        if (!scheduler.fibers) return false;
+        for (auto i = fiber_count; i-- > 0;) {
+            scheduler.fibers[i] = {{}, scheduler.free_fibers, NO_WORKER};
+            scheduler.free_fibers = &scheduler.fibers[i];
+        }
+
+        current_worker = 0;
+        for (auto i = 1u; i < scheduler.worker_count; ++i) {
+            scheduler.workers[i].thread = create_thread(run_worker, &scheduler.workers[i]);
+            if (!scheduler.workers[i].thread.handle) return false;
+        }
+        return true;
+    }
+
+    auto uninitialize_jobs() -> void {
+        scheduler.stopping.store(true, std::memory_order_seq_cst);
+        scheduler.epoch.fetch_add(1u, std::memory_order_seq_cst);
+        wake_on_address(scheduler.epoch, ~0u);
+
+        for (auto i = 1u; i < scheduler.worker_count; ++i) {
+            join_thread(scheduler.workers[i].thread);
+            scheduler.workers[i].thread = {};
+        }
+        for (auto i = 0u; i < scheduler.worker_count; ++i) scheduler.workers[i].deque.release();
+        scheduler.injected.release();
+        scheduler.stacks.release();
+        deallocate(scheduler.fibers, memory_tag::core);
+        scheduler.fibers = nullptr;
+        scheduler.free_fibers = nullptr;
+        scheduler.resumed_head.store(nullptr, std::memory_order_relaxed);
+        scheduler.resumed_tail = nullptr;
+        scheduler.worker_count = 0;
+        current_worker = NO_WORKER;
+    }
+
+    auto run_jobs(job* jobs, size_t count, job_counter* counter) -> void {
+        if (counter) counter->_pending.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            jobs[i].counter = counter;
+            push(&jobs[i]);
+        }
+        if (count) notify(static_cast<uint32_t>(count));
+    }
+
+    auto run_jobs_after(job_counter& dependency, job* jobs, size_t count, job_counter* counter) -> void {
+        if (counter) counter->_pending.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            jobs[i].counter = counter;
+            jobs[i].next = i + 1 < count ? &jobs[i + 1] : nullptr;
+        }
+        if (!count) return;
+
+        dependency._lock.lock();
+        if (dependency._pending.load(std::memory_order_acquire) != 0u) {
+            jobs[count - 1].next = dependency._continuations;
+            dependency._continuations = jobs;
+            dependency._lock.unlock();
+            return;
+        }
+        dependency._lock.unlock();
+
+        for (size_t i = 0; i < count; ++i) push(&jobs[i]);
+        notify(static_cast<uint32_t>(count));
+    }
+
+    auto wait_for_counter(job_counter& counter) -> void {
+        auto const index = worker_index();
+        if (index != NO_WORKER) {
+            auto& self = scheduler.workers[index];
+            counter._lock.lock();
+            if (counter._pending.load(std::memory_order_acquire) == 0u) {
+                counter._lock.unlock();
+                return;
+            }
+
+            // Park this fiber on the counter and keep the worker busy with another.  The counter stays locked until
+            // we are off this stack, so finish_job() can't resume it while it is still running here
+            auto next = take_ready_fiber(self);
+            if (!next) next = take_fiber();
+            if (next) {
+                auto const current = self.running;
+                current->next = counter._fibers;
+                counter._fibers = current;
+                switch_to(self, next, nullptr, &counter._lock);
+                return;
+            }
+            counter._lock.unlock();
+        }
+
+        // Not a worker, or out of fibers: help where we can, then block
+        auto spins = 0u;
+        while (counter._pending.load(std::memory_order_acquire) != 0u) {
+            auto const current = worker_index();
+            if (current != NO_WORKER) {
+                if (auto const job = find_job(scheduler.workers[current])) {
+                    execute(job);
+                    spins = 0;
+                    continue;
+                }
+            }
+            if (++spins < IDLE_SPINS) {
+                CPU_PAUSE();
+                continue;
+            }
+
+            counter._waiters.fetch_add(1u, std::memory_order_seq_cst);
+            auto const pending = counter._pending.load(std::memory_order_seq_cst);
+            if (pending != 0u) wait_on_address(counter._pending, pending);
+            counter._waiters.fetch_sub(1u, std::memory_order_relaxed);
+            spins = 0;
+        }
+
+        // Let a finish_job() that is still inside the counter get out before the caller can destroy it
+        counter._lock.lock();
+        counter._lock.unlock();
+    }
+
+    auto job_worker_count() -> uint32_t { return scheduler.worker_count; }
+    auto job_worker_index() -> uint32_t { return worker_index(); }
+}
@@ -0,0 +1,74 @@
+#ifndef ENGINE_PLATFORM_PLATFORM_JOBS_H
+#define ENGINE_PLATFORM_PLATFORM_JOBS_H
+
+#include <engine/core/types.h>
+#include <engine/core/spin_lock.h>
+
+// Work stealing job system.  Every worker thread, plus the thread that called initialize_jobs() as worker 0, owns a
+// Chase-Lev deque: jobs it spawns go to its own bottom and it runs them newest first, while idle workers steal the
+// oldest from the top of a random victim.  Jobs scheduled from threads that aren't workers go through a shared queue.
+// Workers with nothing to do spin briefly, then park on a futex until new work is scheduled.
+//
+// Jobs run on fibers from a fixed pool.  A job that waits on a counter suspends its fiber and the worker carries on
+// with other jobs on a fresh one; the fiber continues on whichever worker is free once the counter reaches zero, so
+// jobs must not hold on to anything tied to a thread across a wait.  The thread that called initialize_jobs() waits
+// the same way but always resumes on its own thread.  Other threads block.
+//
+// Jobs are not copied: a job must stay alive and unchanged until it has run, which waiting on its counter guarantees
+namespace xc::platform {
+    class job_counter;
+    struct job_fiber;
+
+    struct job {
+        void (*function)(void* data);
+        void* data;
+
+        // Filled in by the scheduler
+        job_counter* counter;
+        job* next;
+    };
+
+    // Number of unfinished jobs, plus the jobs deferred until it reaches zero.  Zero initialized, and reusable as
+    // soon as it is back at zero
+    class job_counter {
+    public:
+        [[nodiscard]] auto done() const -> bool { return _pending.load(std::memory_order_acquire) == 0u; }
+
+    private:
+        friend auto run_jobs(job* jobs, size_t count, job_counter* counter) -> void;
+        friend auto run_jobs_after(job_counter& dependency, job* jobs, size_t count, job_counter* counter) -> void;
+        friend auto wait_for_counter(job_counter& counter) -> void;
+        friend auto finish_job(job_counter& counter) -> void;
+
+        std::atomic<uint32_t> _pending = 0u;
+        std::atomic<uint32_t> _waiters = 0u;
+        spin_lock _lock;             // guards _continuations, _fibers and the final decrement
+        job* _continuations = nullptr;
+        job_fiber* _fibers = nullptr;
+    };
+
+    // Stack of every fiber, so of every job and whatever it calls.  A guard page below each one catches overflows
+    auto static constexpr JOB_STACK_SIZE = size_t{256} << 10;
+    auto static constexpr FIBERS_PER_WORKER = 16u;
+
+    // Starts worker_count threads, or one per processor besides the calling thread when 0.  The calling thread becomes
+    // worker 0 and is the only one that may call uninitialize_jobs(), after every counter it cares about is done
+    auto initialize_jobs(uint32_t worker_count = 0) -> bool;
+    auto uninitialize_jobs() -> void;
+
+    // Schedules count jobs, adding them to counter if there is one.  Runs a job inline when the queues are full
+    auto run_jobs(job* jobs, size_t count, job_counter* counter = nullptr) -> void;
+
+    // Schedules the jobs once dependency reaches zero, or right away if it already has.  They count towards counter
+    // from now on, so waiting on counter also waits for the dependency
+    auto run_jobs_after(job_counter& dependency, job* jobs, size_t count, job_counter* counter = nullptr) -> void;
+
+    auto wait_for_counter(job_counter& counter) -> void;
+
+    // Worker threads including worker 0, and the calling thread's index among them (~0u on other threads).  Useful for
+    // per worker scratch memory
+    auto job_worker_count() -> uint32_t;
+    auto job_worker_index() -> uint32_t;
+}
+
+#endif // ENGINE_PLATFORM_PLATFORM_JOBS_H
@@ -1,6 +1,7 @@
 #ifndef ENGINE_PLATFORM_PLATFORM_SYSTEM_H
 #define ENGINE_PLATFORM_PLATFORM_SYSTEM_H
 
+#include <engine/platform/platform_types.h>
 #include <engine/core/types.h>
 #include <engine/core/string.h>
 
@@ -15,6 +16,92 @@ namespace xc::platform {
     auto unload_library(void* library) -> void;
 
     auto load_function(void* library, char const* name) -> void*;
+
+    // Picks the memcpy, memmove, memset and memcmp kernels for this CPU.  Called by initialize(), but the functions
+    // also resolve themselves on first use
+    auto resolve_memory_functions() -> void;
+
+    // Returns the calling thread's cached free blocks to the shared heap.  Call before a thread exits
+    auto flush_allocation_cache() -> void;
+
+    // Threads.  create_thread() runs function(argument) on a new thread with its own stack; join_thread() waits for it
+    // to return and frees the stack.  Threads flush their allocation cache on the way out
+    auto create_thread(void (*function)(void*), void* argument, size_t stack_size = size_t{1} << 20) -> thread_t;
+    auto join_thread(thread_t thread) -> void;
+    auto yield_thread() -> void;
+
+    // Logical processors this process may run on
+    auto processor_count() -> uint32_t;
+
+    // Nanoseconds since an arbitrary point, never going backwards.  For measuring intervals
+    auto monotonic_time() -> uint64_t;
+
+    // Memory telemetry, recorded when built with MEMORY_TELEMETRY.  Sizes are the block sizes handed out, not the
+    // requested ones.  With sampling enabled every Nth allocation on a thread records its call site (0 turns it off)
+    auto get_memory_stats(memory_tag tag) -> memory_stats;
+    auto set_allocation_sampling(uint32_t interval) -> void;
+    auto dump_memory_stats() -> void;
+
+    // Virtual memory.  reserve_memory() only claims address space; ranges inside it must be committed before use
+    auto reserve_memory(size_t size) -> void*;
+    auto commit_memory(void* address, size_t size, memory_flags flags = memory_flags::none) -> bool;
+    auto decommit_memory(void* address, size_t size) -> void;
+    auto release_memory(void* address, size_t size) -> void;
+
+    // Buffer that grows in place inside a fixed reservation, so its data never moves.  No destructor, call release()
+    class virtual_buffer {
+    public:
+        auto reserve(size_t capacity, memory_flags flags = memory_flags::none) -> bool {
+            auto const granule = granule_size(flags);
+            capacity = (capacity + granule - 1) & ~(granule - 1);
+            _data = static_cast<char*>(reserve_memory(capacity));
+            if (!_data) return false;
+
+            _capacity = capacity;
+            _flags = flags;
+            return true;
+        }
+
+        auto resize(size_t size) -> bool {
+            if (size > _capacity) return false;
+
+            auto const granule = granule_size(_flags);
+            auto const committed = (size + granule - 1) & ~(granule - 1);
+            if (committed > _committed) {
+                if (!commit_memory(_data + _committed, committed - _committed, _flags)) return false;
+            } else if (committed < _committed) {
+                decommit_memory(_data + committed, _committed - committed);
+            }
+
+            _committed = committed;
+            _size = size;
+            return true;
+        }
+
+        auto release() -> void {
+            if (_data) release_memory(_data, _capacity);
+            _data = nullptr;
+            _size = 0u;
+            _committed = 0u;
+            _capacity = 0u;
+        }
+
+        [[nodiscard]] auto data() const -> void* { return _data; }
+        [[nodiscard]] auto size() const -> size_t { return _size; }
+        [[nodiscard]] auto capacity() const -> size_t { return _capacity; }
+
+    private:
+        char* _data = nullptr;
+        size_t _size = 0u;
+        size_t _committed = 0u;
+        size_t _capacity = 0u;
+        memory_flags _flags = memory_flags::none;
+
+        // Commit in 64 KiB steps, or whole 2 MiB pages when huge pages were requested
+        auto static granule_size(memory_flags flags) -> size_t {
+            return (flags & memory_flags::huge_pages) ? size_t{2} << 20 : size_t{64} << 10;
+        }
+    };
 }
 
 auto print(const char *format, ...) -> void;
@@ -1,8 +1,33 @@
 #ifndef ENGINE_PLATFORM_PLATFORM_TYPES_H
 #define ENGINE_PLATFORM_PLATFORM_TYPES_H
 
+#include <engine/core/types.h>
+
 namespace xc::platform {
+    enum class memory_flags : uint32_t {
+        none = 0u,
+        huge_pages = 1u << 0u,  // ask for transparent huge pages on committed ranges
+        prefault = 1u << 1u,    // fault pages in at commit time instead of on first touch
+    };
+
+    constexpr auto operator|(memory_flags a, memory_flags b) -> memory_flags { return static_cast<memory_flags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b)); }
+    constexpr auto operator&(memory_flags a, memory_flags b) -> bool { return (static_cast<uint32_t>(a) & static_cast<uint32_t>(b)) != 0u; }
+
+    // Allocation sizes are bucketed by power of two: <= 16 bytes, <= 32 bytes, ..., the last bucket takes the rest
+    auto static constexpr MEMORY_HISTOGRAM_BUCKETS = 16u;
+
+    // Opaque; a null handle means the thread could not be created
+    struct thread_t {
+        void* handle;
+    };
 
+    struct memory_stats {
+        uint64_t live_bytes;
+        uint64_t peak_bytes;
+        uint64_t allocations;
+        uint64_t frees;
+        uint64_t histogram[MEMORY_HISTOGRAM_BUCKETS];
+    };
 }
 
-#endif // ENGINE_PLATFORM_PLATFORM_TYPES_H
\ No newline at end of file
+#endif // ENGINE_PLATFORM_PLATFORM_TYPES_H
@@ -0,0 +1,72 @@
+; Fiber context switch for the Windows x64 calling convention.  Same scheme as the System V version in
+; platform_fiber.cpp, plus rdi, rsi, xmm6 to xmm15 and the stack bounds kept in the TEB, which the kernel checks
+; when it grows or unwinds a stack.  The frame must match fiber_frame in platform_fiber.cpp
+
+.code
+
+; rcx = where to save the current stack pointer, rdx = stack pointer to continue on
+xc_switch_fiber PROC
+    push rbp
+    push rbx
+    push rdi
+    push rsi
+    push r12
+    push r13
+    push r14
+    push r15
+    push qword ptr gs:[8]       ; StackBase
+    push qword ptr gs:[16]      ; StackLimit
+    push qword ptr gs:[1478h]   ; DeallocationStack
+    sub rsp, 176
+    movaps [rsp], xmm6
+    movaps [rsp + 16], xmm7
+    movaps [rsp + 32], xmm8
+    movaps [rsp + 48], xmm9
+    movaps [rsp + 64], xmm10
+    movaps [rsp + 80], xmm11
+    movaps [rsp + 96], xmm12
+    movaps [rsp + 112], xmm13
+    movaps [rsp + 128], xmm14
+    movaps [rsp + 144], xmm15
+    stmxcsr dword ptr [rsp + 160]
+    fnstcw word ptr [rsp + 164]
+
+    mov [rcx], rsp
+    mov rsp, rdx
+
+    movaps xmm6, [rsp]
+    movaps xmm7, [rsp + 16]
+    movaps xmm8, [rsp + 32]
+    movaps xmm9, [rsp + 48]
+    movaps xmm10, [rsp + 64]
+    movaps xmm11, [rsp + 80]
+    movaps xmm12, [rsp + 96]
+    movaps xmm13, [rsp + 112]
+    movaps xmm14, [rsp + 128]
+    movaps xmm15, [rsp + 144]
+    ldmxcsr dword ptr [rsp + 160]
+    fldcw word ptr [rsp + 164]
+    add rsp, 176
+    pop qword ptr gs:[1478h]
+    pop qword ptr gs:[16]
+    pop qword ptr gs:[8]
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    pop rsi
+    pop rdi
+    pop rbx
+    pop rbp
+    ret
+xc_switch_fiber ENDP
+
+; First return of a fresh fiber: entry(argument) with the shadow space the convention asks for
+xc_start_fiber PROC
+    mov rcx, r13
+    sub rsp, 32
+    call r12
+    ud2
+xc_start_fiber ENDP
+
+END
@@ -1,4 +1,5 @@
 #include <engine/platform/platform_system.h>
+#include <engine/core/epoch.h>
 
 #include <Windows.h>
 
@@ -72,6 +73,89 @@ namespace xc::platform {
         if (!function) print("Failed to load function: %s\n", name);
         return function;
     }
+
+    auto resolve_memory_functions() -> void {}
+
+    auto flush_allocation_cache() -> void {}
+
+    // Thread start routines take a different signature, so the function and argument travel in a small heap block
+    struct thread_start {
+        void (*function)(void*);
+        void* argument;
+    };
+
+    auto static WINAPI run_thread(LPVOID parameter) -> DWORD {
+        auto const start = *static_cast<thread_start*>(parameter);
+        HeapFree(GetProcessHeap(), 0, parameter);
+        start.function(start.argument);
+        epoch::release_thread();
+        flush_allocation_cache();
+        return 0;
+    }
+
+    auto create_thread(void (*function)(void*), void* argument, size_t stack_size) -> thread_t {
+        auto const start = static_cast<thread_start*>(HeapAlloc(GetProcessHeap(), 0, sizeof(thread_start)));
+        if (!start) return {};
+        *start = {function, argument};
+
+        auto const thread = CreateThread({}, stack_size, run_thread, start, STACK_SIZE_PARAM_IS_A_RESERVATION, {});
+        if (!thread) HeapFree(GetProcessHeap(), 0, start);
+        return {thread};
+    }
+
+    auto join_thread(thread_t thread) -> void {
+        if (!thread.handle) return;
+        WaitForSingleObject(thread.handle, INFINITE);
+        CloseHandle(thread.handle);
+    }
+
+    auto yield_thread() -> void { SwitchToThread(); }
+
+    auto processor_count() -> uint32_t { return GetActiveProcessorCount(ALL_PROCESSOR_GROUPS); }
+
+    // Split so the multiplication can't overflow for counters running at several GHz
+    auto monotonic_time() -> uint64_t {
+        LARGE_INTEGER counter, frequency;
+        QueryPerformanceCounter(&counter);
+        QueryPerformanceFrequency(&frequency);
+        auto const ticks = static_cast<uint64_t>(counter.QuadPart), rate = static_cast<uint64_t>(frequency.QuadPart);
+        return ticks / rate * 1'000'000'000u + ticks % rate * 1'000'000'000u / rate;
+    }
+
+    // Large pages need SeLockMemoryPrivilege and must be requested at reservation time, so huge_pages is ignored here
+    auto reserve_memory(size_t size) -> void* { return VirtualAlloc({}, size, MEM_RESERVE, PAGE_NOACCESS); }
+
+    auto commit_memory(void* address, size_t size, memory_flags flags) -> bool {
+        if (!VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE)) return false;
+        if (flags & memory_flags::prefault) {
+            for (auto offset = size_t{}; offset < size; offset += 4096)
+                static_cast<char volatile*>(address)[offset] = 0;
+        }
+        return true;
+    }
+
+    auto decommit_memory(void* address, size_t size) -> void { VirtualFree(address, size, MEM_DECOMMIT); }
+    auto release_memory(void* address, size_t) -> void { VirtualFree(address, 0, MEM_RELEASE); }
+
+    // Telemetry is only recorded by the Linux allocator
+    auto get_memory_stats(memory_tag) -> memory_stats { return {}; }
+    auto set_allocation_sampling(uint32_t) -> void {}
+    auto dump_memory_stats() -> void { print("Memory telemetry is not available on this platform\n"); }
+}
+
+namespace xc {
+    auto allocate(size_t size, memory_tag) -> void* { return malloc(size); }
+    auto deallocate(void* ptr, memory_tag) -> void { free(ptr); }
+    auto reallocate(void* ptr, size_t size, memory_tag) -> void* { return realloc(ptr, size); }
+
+    auto wait_on_address(std::atomic<uint32_t>& word, uint32_t expected) -> void {
+        WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+    }
+
+    auto wake_on_address(std::atomic<uint32_t>& word, uint32_t count) -> void {
+        if (count == 1u) WakeByAddressSingle(&word);
+        else WakeByAddressAll(&word);
+    }
 }
 
 
@@ -101,6 +185,9 @@ auto print(const char* message, ...) -> void {
 
 extern "C" {
 auto __cdecl malloc(size_t size) -> void* { return HeapAlloc(GetProcessHeap(), 0, size); }
+auto __cdecl realloc(void* ptr, size_t size) -> void* {
+    return ptr ? HeapReAlloc(GetProcessHeap(), 0, ptr, size) : HeapAlloc(GetProcessHeap(), 0, size);
+}
 auto __cdecl free(void* ptr) -> void { HeapFree(GetProcessHeap(), 0, ptr); }
 
 #pragma function(memset)
@@ -123,4 +210,25 @@ auto __cdecl memcpy(void *dest, const void *src, size_t count) -> void* {
     }
     return dest;
 }
+
+auto __cdecl memmove(void *dest, const void *src, size_t count) -> void* {
+    char *dest8 = (char *)dest;
+    const char *src8 = (const char *)src;
+    if (dest8 < src8) {
+        while (count--) *dest8++ = *src8++;
+    } else {
+        while (count--) dest8[count] = src8[count];
+    }
+    return dest;
+}
+
+#pragma function(memcmp)
+auto __cdecl memcmp(const void *lhs, const void *rhs, size_t count) -> int {
+    const unsigned char *a = (const unsigned char *)lhs;
+    const unsigned char *b = (const unsigned char *)rhs;
+    for (size_t i = 0; i < count; i++) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
 }
\ No newline at end of file
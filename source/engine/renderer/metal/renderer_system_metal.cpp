@@ -21,4 +21,7 @@ namespace xc::renderer {
     auto tick() -> void {
 
     }
+
+    auto attach_thread() -> void {}
+    auto detach_thread() -> void {}
 };
\ No newline at end of file
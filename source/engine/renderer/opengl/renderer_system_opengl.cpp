@@ -144,6 +144,9 @@ namespace xc::renderer {
         SwapBuffers(hdc);
     }
 
+    auto attach_thread() -> void { reinterpret_cast<PFN_wglMakeCurrent>(xc::platform::load_function(library, "wglMakeCurrent"))(hdc, context); }
+    auto detach_thread() -> void { reinterpret_cast<PFN_wglMakeCurrent>(xc::platform::load_function(library, "wglMakeCurrent"))({}, {}); }
+
 
     // Resources //////////////////////////////////////////////////////////////////////////////////////////////////////
     auto create_shader(char const* vs_source, char const* fs_source) -> shader_t {
@@ -0,0 +1,183 @@
+#ifndef ENGINE_RENDERER_RENDERER_CULLING_H
+#define ENGINE_RENDERER_RENDERER_CULLING_H
+
+#include <engine/core/types.h>
+#include <engine/core/bitset.h>
+#include <engine/core/cpu.h>
+#include <engine/core/math.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define CULLING_SIMD 1
+#endif
+
+// Visibility tests over structure of arrays bounding spheres.  Spheres are tested 8 at a time with AVX2 when the CPU
+// has it and 4 at a time with SSE2 otherwise, 64 to a bitset word; the scalar tail does the same arithmetic, so the
+// answer for a sphere never depends on the path.  Results come out as a bitset (bit i set when sphere i may be
+// visible) or as a compacted, ascending list of visible indices.  Tests are conservative: spheres straddling a
+// boundary are kept
+namespace xc::renderer {
+    struct sphere_stream {
+        float const* x;
+        float const* y;
+        float const* z;
+        float const* radius;
+    };
+
+    // Clip space depth of the graphics API: [0, w] for Vulkan and Metal, [-w, w] for OpenGL
+    enum class depth_range { zero_to_one, minus_one_to_one };
+
+    // Six planes facing inwards, (normal, distance) with unit normals, so signed distances are in world units
+    struct frustum {
+        vector4 planes[6];
+    };
+
+    // Everything within distance of origin, such as a sensor or streaming radius
+    struct view_range {
+        vector3 origin;
+        float distance;
+    };
+
+    // Gribb and Hartmann: each plane is the sum or difference of the last row of the matrix and one of the others
+    auto inline make_frustum(matrix4 const& view_projection, depth_range depth = depth_range::zero_to_one) -> frustum {
+        auto const rows = transpose(view_projection);
+        auto result = frustum{{rows.w + rows.x, rows.w - rows.x, rows.w + rows.y, rows.w - rows.y,
+                               depth == depth_range::zero_to_one ? rows.z : rows.w + rows.z, rows.w - rows.z}};
+        for (auto& plane : result.planes) plane = plane / length(vector3{plane.x, plane.y, plane.z});
+        return result;
+    }
+
+    // Kernels /////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Scalar reference for one sphere.  Outside a plane means the signed distance of the centre is below -radius
+    auto inline visible_scalar(frustum const& f, sphere_stream s, size_t i) -> bool {
+        auto const negative_radius = -s.radius[i];
+        auto outside = false;
+        for (auto const& p : f.planes) outside |= ((p.x * s.x[i] + p.y * s.y[i]) + p.z * s.z[i]) + p.w < negative_radius;
+        return !outside;
+    }
+
+    auto inline visible_scalar(view_range const& r, sphere_stream s, size_t i) -> bool {
+        auto const dx = s.x[i] - r.origin.x, dy = s.y[i] - r.origin.y, dz = s.z[i] - r.origin.z;
+        auto const reach = r.distance + s.radius[i];
+        return (dx * dx + dy * dy) + dz * dz <= reach * reach;
+    }
+
+    // Sets the bits of the visible spheres in [begin, end); the words must start out cleared
+    template<typename Volume> auto inline cull_scalar(Volume const& volume, sphere_stream s, size_t begin, size_t end, uint64_t* words) -> void {
+        for (auto i = begin; i < end; ++i) words[i / bits::WORD_BITS] |= uint64_t{visible_scalar(volume, s, i)} << (i % bits::WORD_BITS);
+    }
+
+#if CULLING_SIMD
+    // One movemask of visibility bits for the spheres starting at i
+    auto inline visible_sse2(frustum const& f, sphere_stream s, size_t i) -> uint64_t {
+        auto const x = _mm_loadu_ps(s.x + i), y = _mm_loadu_ps(s.y + i), z = _mm_loadu_ps(s.z + i);
+        auto const negative_radius = _mm_xor_ps(_mm_loadu_ps(s.radius + i), _mm_set1_ps(-0.f));
+        auto outside = _mm_setzero_ps();
+        for (auto const& p : f.planes) {
+            auto const distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), x), _mm_mul_ps(_mm_set1_ps(p.y), y)),
+                                                        _mm_mul_ps(_mm_set1_ps(p.z), z)), _mm_set1_ps(p.w));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negative_radius));
+        }
+        return static_cast<uint64_t>(_mm_movemask_ps(outside) ^ 0xf);
+    }
+
+    TARGET_AVX2 auto inline visible_avx2(frustum const& f, sphere_stream s, size_t i) -> uint64_t {
+        auto const x = _mm256_loadu_ps(s.x + i), y = _mm256_loadu_ps(s.y + i), z = _mm256_loadu_ps(s.z + i);
+        auto const negative_radius = _mm256_xor_ps(_mm256_loadu_ps(s.radius + i), _mm256_set1_ps(-0.f));
+        auto outside = _mm256_setzero_ps();
+        for (auto const& p : f.planes) {
+            auto const distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.x), x), _mm256_mul_ps(_mm256_set1_ps(p.y), y)),
+                                                              _mm256_mul_ps(_mm256_set1_ps(p.z), z)), _mm256_set1_ps(p.w));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negative_radius, _CMP_LT_OQ));
+        }
+        return static_cast<uint64_t>(_mm256_movemask_ps(outside) ^ 0xff);
+    }
+
+    auto inline visible_sse2(view_range const& r, sphere_stream s, size_t i) -> uint64_t {
+        auto const dx = _mm_sub_ps(_mm_loadu_ps(s.x + i), _mm_set1_ps(r.origin.x));
+        auto const dy = _mm_sub_ps(_mm_loadu_ps(s.y + i), _mm_set1_ps(r.origin.y));
+        auto const dz = _mm_sub_ps(_mm_loadu_ps(s.z + i), _mm_set1_ps(r.origin.z));
+        auto const reach = _mm_add_ps(_mm_set1_ps(r.distance), _mm_loadu_ps(s.radius + i));
+        auto const distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        return static_cast<uint64_t>(_mm_movemask_ps(_mm_cmple_ps(distance, _mm_mul_ps(reach, reach))));
+    }
+
+    TARGET_AVX2 auto inline visible_avx2(view_range const& r, sphere_stream s, size_t i) -> uint64_t {
+        auto const dx = _mm256_sub_ps(_mm256_loadu_ps(s.x + i), _mm256_set1_ps(r.origin.x));
+        auto const dy = _mm256_sub_ps(_mm256_loadu_ps(s.y + i), _mm256_set1_ps(r.origin.y));
+        auto const dz = _mm256_sub_ps(_mm256_loadu_ps(s.z + i), _mm256_set1_ps(r.origin.z));
+        auto const reach = _mm256_add_ps(_mm256_set1_ps(r.distance), _mm256_loadu_ps(s.radius + i));
+        auto const distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        return static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_mul_ps(reach, reach), _CMP_LE_OQ)));
+    }
+
+    // Whole words only; each returns how many spheres it covered and the caller finishes the rest
+    template<typename Volume> auto inline cull_sse2(Volume const& volume, sphere_stream s, size_t count, uint64_t* words) -> size_t {
+        auto const full = count / bits::WORD_BITS;
+        for (size_t w = 0; w < full; ++w) {
+            auto word = uint64_t{};
+            for (size_t lane = 0; lane < bits::WORD_BITS; lane += 4) word |= visible_sse2(volume, s, w * bits::WORD_BITS + lane) << lane;
+            words[w] = word;
+        }
+        return full * bits::WORD_BITS;
+    }
+
+    template<typename Volume> TARGET_AVX2 auto inline cull_avx2(Volume const& volume, sphere_stream s, size_t count, uint64_t* words) -> size_t {
+        auto const full = count / bits::WORD_BITS;
+        for (size_t w = 0; w < full; ++w) {
+            auto word = uint64_t{};
+            for (size_t lane = 0; lane < bits::WORD_BITS; lane += 8) word |= visible_avx2(volume, s, w * bits::WORD_BITS + lane) << lane;
+            words[w] = word;
+        }
+        return full * bits::WORD_BITS;
+    }
+#endif
+
+    template<typename Volume> auto inline cull_words(Volume const& volume, sphere_stream s, size_t count, uint64_t* words) -> void {
+        auto done = size_t{};
+#if CULLING_SIMD
+        done = cpu_has_avx2() ? cull_avx2(volume, s, count, words) : cull_sse2(volume, s, count, words);
+#endif
+        // Whatever is left is less than a word with SIMD, but everything without it
+        if (done == count) return;
+        memset(words + done / bits::WORD_BITS, 0, (bits::word_count(count) - done / bits::WORD_BITS) * sizeof(uint64_t));
+        cull_scalar(volume, s, done, count, words);
+    }
+
+    // Culling /////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Overwrites bits::word_count(count) words of visible
+    auto inline cull_bits(frustum const& f, sphere_stream spheres, size_t count, uint64_t* visible) -> void { cull_words(f, spheres, count, visible); }
+    auto inline cull_bits(view_range const& r, sphere_stream spheres, size_t count, uint64_t* visible) -> void { cull_words(r, spheres, count, visible); }
+
+    // Resizes visible to count; false if that allocation failed
+    template<memory_tag Tag> auto cull_bits(frustum const& f, sphere_stream spheres, size_t count, dynamic_bitset<Tag>& visible) -> bool {
+        if (!visible.resize(count)) return false;
+        cull_words(f, spheres, count, visible.words());
+        return true;
+    }
+
+    template<memory_tag Tag> auto cull_bits(view_range const& r, sphere_stream spheres, size_t count, dynamic_bitset<Tag>& visible) -> bool {
+        if (!visible.resize(count)) return false;
+        cull_words(r, spheres, count, visible.words());
+        return true;
+    }
+
+    // Writes the indices of the visible spheres in ascending order and returns how many there are.  visible must have
+    // room for count entries.  Bits are produced a block at a time on the stack and expanded while still in cache
+    template<typename Volume> auto cull_indices(Volume const& volume, sphere_stream spheres, size_t count, uint32_t* visible) -> size_t {
+        auto static constexpr BLOCK_WORDS = size_t{64};
+        auto static constexpr BLOCK = BLOCK_WORDS * bits::WORD_BITS;
+
+        uint64_t words[BLOCK_WORDS];
+        auto written = size_t{};
+        for (size_t begin = 0; begin < count; begin += BLOCK) {
+            auto const block = count - begin < BLOCK ? count - begin : BLOCK;
+            auto const block_spheres = sphere_stream{spheres.x + begin, spheres.y + begin, spheres.z + begin, spheres.radius + begin};
+            cull_words(volume, block_spheres, block, words);
+            bits::for_each_set(words, bits::word_count(block), [&](size_t i) { visible[written++] = static_cast<uint32_t>(begin + i); });
+        }
+        return written;
+    }
+} // namespace xc::renderer
+
+#endif // ENGINE_RENDERER_RENDERER_CULLING_H
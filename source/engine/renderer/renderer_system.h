@@ -8,6 +8,11 @@ namespace xc::renderer {
     auto uninitialize() -> void;
     auto tick() -> void;
 
+    // Makes the graphics context current on the calling thread, or lets go of it, so another thread can render.  Does
+    // nothing for APIs whose contexts aren't bound to a thread
+    auto attach_thread() -> void;
+    auto detach_thread() -> void;
+
     // Shaders
     auto create_shader(char const* vs_source, char const* fs_source) -> shader_t;
     auto bind_shader(shader_t const& shader) -> void;
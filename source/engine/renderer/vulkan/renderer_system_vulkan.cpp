@@ -2,6 +2,7 @@
 #include <engine/platform/platform_system.h>
 #include <engine/core/string.h>
 #include <engine/core/array.h>
+#include <engine/core/arena.h>
 
 // Loader //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include <vulkan/vulkan.h>
@@ -238,6 +239,7 @@ static VkQueue graphics_queue;
 // System //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace xc::renderer {
     auto initialize() -> bool {
+        auto scratch = arena_scope{frame_memory.current()};
 
         // Load library
         library = platform::load_library(LIBRARY_NAME);
@@ -278,10 +280,10 @@ namespace xc::renderer {
 
         // Pick physical device ////////////////////////////////////////////////////////////////////////////////////////
         auto device_count = 0u;
-        auto physical_devices = array<VkPhysicalDevice>{}; // TODO: use standard C types
+        auto physical_devices = small_array<VkPhysicalDevice, 4, frame_allocator<VkPhysicalDevice>>{}; // TODO: use standard C types
 
         VK_CHECK(vkEnumeratePhysicalDevices(instance, &device_count, nullptr));
-        physical_devices.resize(device_count);
+        if (!physical_devices.resize(device_count)) return false;
 
         VK_CHECK(vkEnumeratePhysicalDevices(instance, &device_count, physical_devices.data()));
         // TODO: evaluate devices.  For now, just pick the first
@@ -290,9 +292,10 @@ namespace xc::renderer {
 
         // Find queue family indices
         auto queue_family_count = 0u;
-        auto queue_family_properties = array<VkQueueFamilyProperties>{};
+        auto queue_family_properties = small_array<VkQueueFamilyProperties, 8, frame_allocator<VkQueueFamilyProperties>>{};
         vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, {});
-        queue_family_properties.resize(queue_family_count);
+        if (!queue_family_properties.resize(queue_family_count)) return false;
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_family_properties.data());
 
         auto graphics_queue_index = 0u;
         for (auto i = 0u; i < queue_family_count; ++i) {
@@ -301,7 +304,6 @@ namespace xc::renderer {
                 break;
             }
         }
-        queue_family_properties.clear(); // we don't have a destructor for cleanup to avoid SEH
 
         auto queue_priorities = 1.f;
         auto queue_create_info = VkDeviceQueueCreateInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO, {}, {},
@@ -344,4 +346,7 @@ namespace xc::renderer {
     auto tick() -> void {
 
     }
+
+    auto attach_thread() -> void {}
+    auto detach_thread() -> void {}
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 // This is an independent project of an individual developer. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
 
+#include <engine/platform/platform_frame_graph.h>
+#include <engine/platform/platform_frame_pipeline.h>
+#include <engine/platform/platform_jobs.h>
 #include <engine/platform/platform_system.h>
 #include <engine/renderer/renderer_system.h>
+#include <engine/core/arena.h>
 
 auto static constexpr fs_shader = R"(
 #version 330
@@ -179,20 +183,71 @@ void main() {
 
 extern bool running;
 
+// What the frame's systems share, for the frame graph to order them by
+enum frame_resource : xc::platform::resource_mask {
+    input = 1u << 0u,
+    scene = 1u << 1u,
+};
+
+// Frames the simulation may run ahead of the renderer; 0 renders inline at the end of each frame.  Linux threads can't
+// call into shared libraries (see platform_thread_linux.cpp), and rendering calls the GL or Vulkan driver, so the
+// renderer stays on the main thread there
+#if defined(PLATFORM_LINUX)
+auto static constexpr PIPELINE_DEPTH = 0u;
+#else
+auto static constexpr PIPELINE_DEPTH = 1u;
+#endif
+
+// Everything the renderer needs from a frame, so the simulation can move on to the next one
+struct render_snapshot {
+    xc::vector3 position;
+};
+
+using render_pipeline = xc::platform::frame_pipeline<render_snapshot>;
+
 extern "C" auto entry() -> void {
     if (!xc::platform::initialize()) xc::platform::exit(-1);
+    if (!xc::platform::initialize_jobs()) xc::platform::exit(-1);
     if (!xc::renderer::initialize()) xc::platform::exit(-1);
 
     auto shader = xc::renderer::create_shader({}, fs_shader);
 
     xc::renderer::bind_shader(shader);
-    xc::renderer::set_shader_uniform(shader, "position", xc::vector3{0.f, 0.5f, 0.f});
+
+    // Window events have to be pumped on the thread that created the window
+    auto pipeline = render_pipeline{};
+    auto frame = xc::platform::frame_graph{};
+    frame.add_system({"platform", [](void*) { xc::platform::tick(); }, nullptr, 0u, input, true});
+    frame.add_system({"simulation", [](void* data) {
+        auto& snapshot = static_cast<render_pipeline*>(data)->current();
+        snapshot.position = xc::vector3{0.f, 0.5f, 0.f};
+    }, &pipeline, input, scene, false});
+    frame.compile();
+
+    // The GL context moves to whichever thread renders, and back at the end
+    xc::renderer::detach_thread();
+    auto const renderer = render_pipeline::renderer{
+        [](void*) { xc::renderer::attach_thread(); },
+        [](render_snapshot const& snapshot, void* data) {
+            xc::renderer::set_shader_uniform(*static_cast<xc::renderer::shader_t*>(data), "position", snapshot.position);
+            xc::renderer::tick();
+        },
+        [](void*) { xc::renderer::detach_thread(); },
+        &shader};
+    if (!pipeline.start(PIPELINE_DEPTH, renderer)) xc::platform::exit(-1);
 
     while (running) {
-        xc::platform::tick();
-        xc::renderer::tick();
+        // Only once a snapshot is free has the frame that last used the arena being reset finished rendering
+        pipeline.begin_frame();
+        xc::frame_memory.begin_frame();
+        frame.run();
+        pipeline.end_frame();
     }
 
+    pipeline.stop();
+    xc::renderer::attach_thread();
+
+    xc::platform::uninitialize_jobs();
     xc::platform::uninitialize();
 
     xc::platform::exit(0);
@@ -201,6 +256,5 @@ extern "C" auto entry() -> void {
 
 // TODO:
 // Wrap if (!thing) print() lines in a macro that removes the generated code in release builds
-// small buffer optimization for array
 // event system
 // replace extern bool running with events?
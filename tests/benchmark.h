@@ -0,0 +1,36 @@
+#ifndef TESTS_BENCHMARK_H
+#define TESTS_BENCHMARK_H
+
+// Before any engine header: core/types.h defines a move() macro that breaks the standard headers included after it
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Timing for the hosted benchmarks.  A benchmark runs its body a few times and keeps the fastest, which is the run
+// least disturbed by the rest of the machine
+namespace bench {
+    // Results are folded in here so the optimizer can't drop the work that produced them
+    inline volatile uint64_t sink = 0u;
+
+    auto inline now() -> uint64_t {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Nanoseconds of the fastest of count runs
+    template<typename F> auto best_of(uint32_t count, F&& function) -> double {
+        auto best = ~uint64_t{};
+        for (auto i = 0u; i < count; ++i) {
+            auto const start = now();
+            function();
+            auto const time = now() - start;
+            best = time < best ? time : best;
+        }
+        return static_cast<double>(best);
+    }
+
+    auto inline report(char const* name, double nanoseconds, double operations) -> void {
+        printf("%-48s %12.3f ns/op %14.1f op/s\n", name, nanoseconds / operations, operations / nanoseconds * 1e9);
+    }
+}
+
+#endif // TESTS_BENCHMARK_H
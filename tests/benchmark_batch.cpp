@@ -0,0 +1,63 @@
+#include "benchmark.h"
+
+#include <vector>
+
+#include <engine/core/batch.h>
+
+// Points per nanosecond through the core/batch.h kernels, scalar against the SSE2 and AVX2 paths and the dispatching
+// entry point the engine calls.  The sizes stay in L1, stay in L2 and stream from memory
+using namespace xc;
+
+auto static constexpr RUNS = 20u;
+
+struct streams {
+    std::vector<float> x, y, z;
+
+    explicit streams(size_t count) : x(count), y(count), z(count) {
+        auto state = 0x2545f491u;
+        for (auto* column : {&x, &y, &z})
+            for (auto& value : *column) {
+                state ^= state << 13u;
+                state ^= state >> 17u;
+                state ^= state << 5u;
+                value = static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u) * 8.f - 4.f;
+            }
+    }
+
+    auto view() -> batch::vector3_stream { return {x.data(), y.data(), z.data()}; }
+};
+
+template<typename F> auto static run(char const* kernel, char const* path, size_t count, F&& function) -> void {
+    auto const time = bench::best_of(RUNS, function);
+    char label[64];
+    snprintf(label, sizeof(label), "%s %s, %zu points", kernel, path, count);
+    printf("%-48s %12.3f points/ns\n", label, static_cast<double>(count) / time);
+}
+
+auto main() -> int {
+    auto const m = matrix4{{0.f, 1.f, 0.f, 0.f}, {-1.f, 0.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}, {3.f, 4.f, 5.f, 1.f}};
+    auto const avx2 = cpu_has_avx2();
+    if (!avx2) printf("no AVX2 on this CPU, skipping those rows\n");
+
+    for (auto count : {size_t{1024}, size_t{16384}, size_t{1} << 20u}) {
+        auto in = streams(count), out = streams(count), velocity = streams(count);
+
+        run("transform_points", "scalar", count, [&] { batch::transform_scalar(m, 1.f, in.view(), out.view(), 0u, count); });
+        run("transform_points", "sse2", count, [&] { batch::transform_sse2(m, 1.f, in.view(), out.view(), count); });
+        if (avx2) run("transform_points", "avx2", count, [&] { batch::transform_avx2(m, 1.f, in.view(), out.view(), count); });
+        run("transform_points", "dispatch", count, [&] { batch::transform_points(m, in.view(), out.view(), count); });
+
+        // Small dt keeps positions from drifting far over the runs
+        run("integrate", "scalar", count, [&] { batch::integrate_scalar(out.view(), velocity.view(), 1e-6f, 0u, count); });
+        run("integrate", "sse2", count, [&] { batch::integrate_sse2(out.view(), velocity.view(), 1e-6f, count); });
+        if (avx2) run("integrate", "avx2", count, [&] { batch::integrate_avx2(out.view(), velocity.view(), 1e-6f, count); });
+        run("integrate", "dispatch", count, [&] { batch::integrate(out.view(), velocity.view(), 1e-6f, count); });
+
+        run("normalize", "scalar", count, [&] { batch::normalize_scalar(in.view(), out.view(), 0u, count); });
+        run("normalize", "sse2", count, [&] { batch::normalize_sse2(in.view(), out.view(), count); });
+        if (avx2) run("normalize", "avx2", count, [&] { batch::normalize_avx2(in.view(), out.view(), count); });
+        run("normalize", "dispatch", count, [&] { batch::normalize(in.view(), out.view(), count); });
+
+        bench::sink = bench::sink + bit_cast<uint32_t>(out.x[count / 2u]);
+    }
+}
@@ -0,0 +1,78 @@
+#include "benchmark.h"
+
+#include <vector>
+
+#include <engine/renderer/renderer_culling.h>
+
+// Spheres culled per microsecond by renderer_culling.h, frustum and view range, over the scalar, SSE2 and AVX2 kernels
+// and the two entry points the renderer calls: cull_bits, and cull_indices, which also compacts the survivors
+using namespace xc;
+using namespace xc::renderer;
+
+auto static constexpr RUNS = 20u;
+
+struct scene {
+    std::vector<float> x, y, z, radius;
+
+    // Uniform in a 200 unit cube around the camera, radii from 0.5 to 2.5
+    explicit scene(size_t count) : x(count), y(count), z(count), radius(count) {
+        auto state = 0x2545f491u;
+        auto const next = [&] {
+            state ^= state << 13u;
+            state ^= state >> 17u;
+            state ^= state << 5u;
+            return static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u);
+        };
+        for (auto i = size_t{}; i < count; ++i) {
+            x[i] = next() * 200.f - 100.f;
+            y[i] = next() * 200.f - 100.f;
+            z[i] = next() * 200.f - 100.f;
+            radius[i] = 0.5f + next() * 2.f;
+        }
+    }
+
+    auto view() const -> sphere_stream { return {x.data(), y.data(), z.data(), radius.data()}; }
+};
+
+template<typename F> auto static run(char const* name, char const* path, size_t count, F&& function) -> void {
+    auto const time = bench::best_of(RUNS, function);
+    char label[64];
+    snprintf(label, sizeof(label), "%s %s, %zu spheres", name, path, count);
+    printf("%-48s %12.1f spheres/us\n", label, static_cast<double>(count) / time * 1e3);
+}
+
+template<typename Volume> auto static run_all(char const* name, Volume const& volume, scene const& spheres, size_t count) -> void {
+    auto const avx2 = cpu_has_avx2();
+    auto words = std::vector<uint64_t>(bits::word_count(count));
+    auto indices = std::vector<uint32_t>(count);
+    auto const s = spheres.view();
+
+    run(name, "scalar", count, [&] {
+        for (auto& word : words) word = 0u;
+        cull_scalar(volume, s, 0u, count, words.data());
+    });
+    run(name, "sse2", count, [&] { cull_sse2(volume, s, count, words.data()); });
+    if (avx2) run(name, "avx2", count, [&] { cull_avx2(volume, s, count, words.data()); });
+    run(name, "cull_bits", count, [&] { cull_bits(volume, s, count, words.data()); });
+
+    auto visible = size_t{};
+    run(name, "cull_indices", count, [&] { visible = cull_indices(volume, s, count, indices.data()); });
+    printf("%-48s %12.1f%% visible\n", "", 100.0 * static_cast<double>(visible) / static_cast<double>(count));
+    bench::sink = bench::sink + visible + words[0];
+}
+
+auto main() -> int {
+    // Looking down -z with a 90 degree field of view, near 0.1 and far 1000, Vulkan depth
+    auto constexpr near = 0.1f, far = 1000.f;
+    auto const projection = matrix4{{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f},
+                                    {0.f, 0.f, far / (near - far), -1.f}, {0.f, 0.f, far * near / (near - far), 0.f}};
+    auto const f = make_frustum(projection);
+    auto const range = view_range{{0.f, 0.f, 0.f}, 80.f};
+    if (!cpu_has_avx2()) printf("no AVX2 on this CPU, skipping those rows\n");
+
+    for (auto count : {size_t{4096}, size_t{65536}, size_t{1} << 20u}) {
+        auto const spheres = scene(count);
+        run_all("frustum", f, spheres, count);
+        run_all("range", range, spheres, count);
+    }
+}
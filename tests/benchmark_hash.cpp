@@ -0,0 +1,69 @@
+#include "benchmark.h"
+#include "legacy_hash.h"
+
+#include <engine/core/hash.h>
+
+// xc::hash against the table it replaced, on 64 bit keys: inserting into an empty table, finding keys that are there
+// and keys that aren't, and erasing them all again.  The legacy table has no tombstones, so its erase is cheaper than
+// a correct one would be
+auto static constexpr COUNT = 1u << 20;
+auto static constexpr RUNS = 5u;
+
+auto static key_of(uint64_t i) -> uint64_t { return wyhash(i); }
+
+template<typename Table, typename Insert, typename Find, typename Remove>
+auto static run(char const* name, Insert insert, Find find, Remove remove) -> void {
+    char label[64];
+    auto const insert_time = bench::best_of(RUNS, [&] {
+        Table table;
+        for (auto i = 0ull; i < COUNT; ++i) insert(table, key_of(i));
+    });
+    snprintf(label, sizeof(label), "%s insert", name);
+    bench::report(label, insert_time, COUNT);
+
+    Table table;
+    for (auto i = 0ull; i < COUNT; ++i) insert(table, key_of(i));
+
+    auto const hit_time = bench::best_of(RUNS, [&] {
+        auto found = 0ull;
+        for (auto i = 0ull; i < COUNT; ++i) found += find(table, key_of(i));
+        bench::sink = bench::sink + found;
+    });
+    snprintf(label, sizeof(label), "%s find hit", name);
+    bench::report(label, hit_time, COUNT);
+
+    auto const miss_time = bench::best_of(RUNS, [&] {
+        auto found = 0ull;
+        for (auto i = 0ull; i < COUNT; ++i) found += find(table, key_of(i + COUNT));
+        bench::sink = bench::sink + found;
+    });
+    snprintf(label, sizeof(label), "%s find miss", name);
+    bench::report(label, miss_time, COUNT);
+
+    // Every run erases from a freshly filled table; filling it isn't timed
+    auto best = ~uint64_t{};
+    for (auto r = 0u; r < RUNS; ++r) {
+        Table erased;
+        for (auto i = 0ull; i < COUNT; ++i) insert(erased, key_of(i));
+        auto const start = bench::now();
+        for (auto i = 0ull; i < COUNT; ++i) remove(erased, key_of(i));
+        auto const time = bench::now() - start;
+        best = time < best ? time : best;
+    }
+    snprintf(label, sizeof(label), "%s erase", name);
+    bench::report(label, static_cast<double>(best), COUNT);
+}
+
+auto main() -> int {
+    using swiss = xc::hash<uint64_t, uint64_t>;
+    using legacy = bench::legacy_hash<uint64_t, uint64_t>;
+
+    run<swiss>("xc::hash",
+               [](swiss& t, uint64_t k) { t.insert(k, k); },
+               [](swiss& t, uint64_t k) -> uint64_t { return t.find(k) != nullptr; },
+               [](swiss& t, uint64_t k) { t.remove(k); });
+    run<legacy>("legacy hash",
+                [](legacy& t, uint64_t k) { t.insert(k, k); },
+                [](legacy& t, uint64_t k) -> uint64_t { auto v = uint64_t{}; return t.find(k, v); },
+                [](legacy& t, uint64_t k) { t.remove(k); });
+}
@@ -0,0 +1,56 @@
+#include "benchmark.h"
+
+#include <engine/core/math.h>
+
+// Cost per call of the core/math.h operations that have an SSE path, over arrays big enough to stream from cache
+// rather than registers.  The scalar code only runs in constant evaluation, so there is no run time scalar number to
+// print beside them; test_math.cpp covers that the two agree
+using namespace xc;
+
+auto static constexpr COUNT = 4096u;
+auto static constexpr RUNS = 200u;
+
+inline vector4 vectors[COUNT], results[COUNT];
+inline matrix4 matrices[COUNT], products[COUNT];
+inline quaternion rotations[COUNT];
+
+template<typename F> auto static run(char const* name, F&& function) -> void {
+    bench::report(name, bench::best_of(RUNS, [&] { for (auto i = 0u; i < COUNT; ++i) function(i); }), COUNT);
+}
+
+auto main() -> int {
+    auto state = 0x2545f491u;
+    auto const next = [&] {
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u) * 8.f - 4.f;
+    };
+    for (auto i = 0u; i < COUNT; ++i) {
+        vectors[i] = {next(), next(), next(), next()};
+        matrices[i] = {{next() + 16.f, next(), next(), next()}, {next(), next() + 16.f, next(), next()},
+                       {next(), next(), next() + 16.f, next()}, {next(), next(), next(), next() + 16.f}};
+        rotations[i] = normalize(quaternion{next(), next(), next(), next()});
+    }
+
+    auto sum = 0.f;
+    run("dot(vector4, vector4)", [&](uint32_t i) { sum += dot(vectors[i], vectors[COUNT - 1u - i]); });
+    run("normalize(vector4)", [&](uint32_t i) { results[i] = normalize(vectors[i]); });
+    run("matrix4 * vector4", [&](uint32_t i) { results[i] = matrices[i] * vectors[i]; });
+    run("matrix4 * matrix4", [&](uint32_t i) { products[i] = matrices[i] * matrices[COUNT - 1u - i]; });
+    run("transpose(matrix4)", [&](uint32_t i) { products[i] = transpose(matrices[i]); });
+    run("inverse(matrix4)", [&](uint32_t i) { products[i] = inverse(matrices[i]); });
+    run("determinant(matrix4)", [&](uint32_t i) { sum += determinant(matrices[i]); });
+    run("rotation(quaternion)", [&](uint32_t i) { products[i] = rotation(rotations[i]); });
+    run("rotate(quaternion, vector3)", [&](uint32_t i) {
+        auto const v = rotate(rotations[i], vector3{vectors[i].x, vectors[i].y, vectors[i].z});
+        results[i] = {v.x, v.y, v.z, 0.f};
+    });
+    run("quaternion * quaternion", [&](uint32_t i) {
+        auto const q = rotations[i] * rotations[COUNT - 1u - i];
+        results[i] = {q.x, q.y, q.z, q.w};
+    });
+
+    bench::sink = bench::sink + static_cast<uint64_t>(sum != 0.f) + bit_cast<uint32_t>(results[COUNT / 2u].x) +
+                  bit_cast<uint32_t>(products[COUNT / 2u].w.w);
+}
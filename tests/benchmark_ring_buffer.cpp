@@ -0,0 +1,144 @@
+#include "benchmark.h"
+
+#include <thread>
+#include <vector>
+
+#include <engine/core/ring_buffer.h>
+
+// Throughput of the rings across producer and consumer counts, one value or a batch at a time, and one way latency
+// measured by bouncing a value between two threads.  The non-blocking rings yield after a failed attempt rather than
+// spin, or a machine with fewer cores than threads would measure the scheduler instead
+auto static constexpr MESSAGES = uint32_t{1} << 20;
+auto static constexpr CAPACITY = 1024u;
+auto static constexpr BATCH = 32u;
+auto static constexpr ROUND_TRIPS = 100000u;
+
+using spsc = xc::spsc_ring_buffer<uint64_t>;
+using mpmc = xc::mpmc_ring_buffer<uint64_t>;
+using blocking_spsc = xc::blocking_ring_buffer<spsc>;
+using blocking_mpmc = xc::blocking_ring_buffer<mpmc>;
+
+template<typename Ring> auto static push(Ring& ring, uint64_t value) -> void {
+    if constexpr (requires { ring.try_push(value); }) ring.push(value);
+    else while (!ring.push(value)) std::this_thread::yield();
+}
+
+template<typename Ring> auto static pop(Ring& ring) -> uint64_t {
+    auto value = uint64_t{};
+    if constexpr (requires { ring.try_pop(value); }) ring.pop(value);
+    else while (!ring.pop(value)) std::this_thread::yield();
+    return value;
+}
+
+template<typename Ring> auto static push_batch(Ring& ring, uint64_t const* values, size_t count) -> void {
+    if constexpr (requires { ring.try_push(*values); }) {
+        ring.push_batch(values, count);
+    } else {
+        while (count > 0) {
+            auto const pushed = ring.push_batch(values, count);
+            if (!pushed) std::this_thread::yield();
+            values += pushed;
+            count -= pushed;
+        }
+    }
+}
+
+template<typename Ring> auto static pop_batch(Ring& ring, uint64_t* values, size_t count) -> size_t {
+    if constexpr (requires { ring.try_pop(*values); }) return ring.pop_batch(values, count);
+    for (;;) {
+        if (auto const popped = ring.pop_batch(values, count)) return popped;
+        std::this_thread::yield();
+    }
+}
+
+template<typename Ring> auto static throughput(char const* name, uint32_t producers, uint32_t consumers, bool batch) -> void {
+    Ring ring;
+    ring.initialize(CAPACITY);
+    std::atomic<uint64_t> total = 0u;
+
+    auto const start = bench::now();
+    std::vector<std::thread> threads;
+    for (auto p = 0u; p < producers; ++p) {
+        threads.emplace_back([&ring, producers, batch] {
+            auto const count = MESSAGES / producers;
+            uint64_t values[BATCH];
+            for (auto i = 0u; i < count;) {
+                if (!batch) {
+                    push(ring, ++i);
+                    continue;
+                }
+                auto const n = count - i < BATCH ? count - i : BATCH;
+                for (auto j = 0u; j < n; ++j) values[j] = ++i;
+                push_batch(ring, values, n);
+            }
+        });
+    }
+    for (auto c = 0u; c < consumers; ++c) {
+        threads.emplace_back([&ring, &total, consumers, batch] {
+            auto const count = MESSAGES / consumers;
+            auto sum = uint64_t{};
+            uint64_t values[BATCH];
+            for (auto i = 0u; i < count;) {
+                if (!batch) {
+                    sum += pop(ring);
+                    ++i;
+                    continue;
+                }
+                auto const popped = pop_batch(ring, values, count - i < BATCH ? count - i : BATCH);
+                for (auto j = size_t{}; j < popped; ++j) sum += values[j];
+                i += static_cast<uint32_t>(popped);
+            }
+            total.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto const time = static_cast<double>(bench::now() - start);
+    ring.release();
+
+    auto const per_producer = uint64_t{MESSAGES / producers};
+    auto const expected = producers * per_producer * (per_producer + 1u) / 2u;
+    char label[96];
+    snprintf(label, sizeof(label), "%s %up/%uc%s%s", name, producers, consumers, batch ? " batch" : "", total.load() == expected ? "" : " WRONG SUM");
+    bench::report(label, time, MESSAGES);
+}
+
+template<typename Ring> auto static latency(char const* name) -> void {
+    Ring there, back;
+    there.initialize(CAPACITY);
+    back.initialize(CAPACITY);
+
+    auto const start = bench::now();
+    std::thread echo{[&] {
+        for (auto i = 0u; i < ROUND_TRIPS; ++i) push(back, pop(there));
+    }};
+    auto sum = uint64_t{};
+    for (auto i = 0u; i < ROUND_TRIPS; ++i) {
+        push(there, i);
+        sum += pop(back);
+    }
+    echo.join();
+    auto const time = static_cast<double>(bench::now() - start);
+    bench::sink = bench::sink + sum;
+    there.release();
+    back.release();
+
+    char label[96];
+    snprintf(label, sizeof(label), "%s one way latency", name);
+    bench::report(label, time / 2.0, ROUND_TRIPS);
+}
+
+auto main() -> int {
+    for (auto batch : {false, true}) {
+        throughput<spsc>("spsc", 1u, 1u, batch);
+        throughput<blocking_spsc>("blocking spsc", 1u, 1u, batch);
+        for (auto threads : {1u, 2u, 4u}) {
+            throughput<mpmc>("mpmc", threads, threads, batch);
+            throughput<blocking_mpmc>("blocking mpmc", threads, threads, batch);
+        }
+    }
+
+    latency<spsc>("spsc");
+    latency<blocking_spsc>("blocking spsc");
+    latency<mpmc>("mpmc");
+    latency<blocking_mpmc>("blocking mpmc");
+}
@@ -0,0 +1,53 @@
+#include "benchmark.h"
+
+#include <engine/core/array.h>
+
+// Heap allocations and time to build short arrays, xc::array against xc::small_array with four inline elements.  The
+// element mimics VkQueueFamilyProperties, the case game.cpp's old TODO was about
+struct queue_family {
+    uint32_t flags, count, timestamp_bits;
+    uint32_t granularity[3];
+};
+
+inline uint64_t allocations = 0u;
+
+// default_allocator that counts every call that reaches the heap
+template<typename T> class counting_allocator : public xc::default_allocator<T> {
+public:
+    auto allocate(size_t n) -> T* {
+        ++allocations;
+        return xc::default_allocator<T>::allocate(n);
+    }
+
+    auto reallocate(T* ptr, size_t n) -> T* {
+        ++allocations;
+        return xc::default_allocator<T>::reallocate(ptr, n);
+    }
+};
+
+auto static constexpr ARRAYS = 100000u;
+auto static constexpr RUNS = 5u;
+
+template<typename Array> auto static run(char const* name, uint32_t elements) -> void {
+    allocations = 0u;
+    auto const time = bench::best_of(RUNS, [&] {
+        for (auto a = 0u; a < ARRAYS; ++a) {
+            Array array;
+            for (auto i = 0u; i < elements; ++i) array.push_back(queue_family{i, a, 64u, {1u, 1u, 1u}});
+            bench::sink = bench::sink + array[elements - 1u].count;
+            array.clear();
+        }
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s, %u elements", name, elements);
+    bench::report(label, time, ARRAYS);
+    printf("%-48s %12.2f allocations/array\n", "", static_cast<double>(allocations) / (RUNS * ARRAYS));
+}
+
+auto main() -> int {
+    for (auto elements : {1u, 2u, 4u, 8u, 16u}) {
+        run<xc::array<queue_family, counting_allocator<queue_family>>>("xc::array", elements);
+        run<xc::small_array<queue_family, 4u, counting_allocator<queue_family>>>("xc::small_array<4>", elements);
+    }
+}
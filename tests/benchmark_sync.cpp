@@ -0,0 +1,60 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <engine/core/spin_lock.h>
+#include <engine/core/sync.h>
+
+// Lock contention: every thread takes the same lock in a loop around a short or a long critical section, and the
+// cost is the wall time per acquisition across all of them.  xc::mutex against xc::spin_lock, with std::mutex for
+// scale.  Spin locks suffer most once there are more threads than cores, since a preempted holder stalls everyone
+auto static constexpr ACQUISITIONS = 200000u;
+auto static constexpr RUNS = 3u;
+
+// Shared state the critical section works on, so the lock protects something
+inline uint64_t counter = 0u;
+
+auto static work(uint32_t amount) -> void {
+    for (auto i = 0u; i < amount; ++i) counter = counter * 6364136223846793005u + 1442695040888963407u;
+}
+
+template<typename Lock> auto static run(char const* name, uint32_t threads, uint32_t inside, uint32_t outside) -> void {
+    auto const per_thread = ACQUISITIONS / threads;
+    auto const time = bench::best_of(RUNS, [&] {
+        Lock lock{};
+        auto go = std::atomic<bool>{false};
+        auto workers = std::vector<std::thread>{};
+        for (auto t = 0u; t < threads; ++t)
+            workers.emplace_back([&] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                auto local = uint64_t{};
+                for (auto i = 0u; i < per_thread; ++i) {
+                    lock.lock();
+                    work(inside);
+                    lock.unlock();
+                    for (auto j = 0u; j < outside; ++j) local = local * 31u + j;
+                }
+                bench::sink = bench::sink + local;
+            });
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) worker.join();
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s, %u threads, %u inside", name, threads, inside);
+    bench::report(label, time, per_thread * threads);
+}
+
+auto main() -> int {
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (auto inside : {4u, 200u})
+        for (auto threads : {1u, 2u, 4u, 8u}) {
+            run<xc::mutex>("xc::mutex", threads, inside, 50u);
+            run<xc::spin_lock>("xc::spin_lock", threads, inside, 50u);
+            run<std::mutex>("std::mutex", threads, inside, 50u);
+        }
+    bench::sink = bench::sink + counter;
+}
@@ -0,0 +1,77 @@
+#include "benchmark.h"
+
+#include <cmath>
+#include <vector>
+
+#include <engine/core/batch.h>
+
+// Throughput of the core/math.h transcendentals: the C library's float functions for scale, the scalar forms, and the
+// 4 and 8 lane kernels through core/batch.h.  test_transcendental.cpp covers their accuracy
+using namespace xc;
+
+auto static constexpr COUNT = size_t{4096};
+auto static constexpr RUNS = 200u;
+
+inline std::vector<float> angles(COUNT), positive(COUNT), exponents(COUNT), ys(COUNT), results(COUNT), other(COUNT);
+
+template<typename F> auto static run(char const* name, char const* path, F&& function) -> void {
+    char label[64];
+    snprintf(label, sizeof(label), "%s %s", name, path);
+    bench::report(label, bench::best_of(RUNS, function), COUNT);
+}
+
+auto main() -> int {
+    auto state = 0x2545f491u;
+    auto const next = [&] {
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u);
+    };
+    for (auto i = size_t{}; i < COUNT; ++i) {
+        angles[i] = next() * 200.f - 100.f;
+        positive[i] = std::ldexp(1.f + next(), static_cast<int>(next() * 40.f) - 20);
+        exponents[i] = next() * 160.f - 80.f;
+        ys[i] = next() * 8.f - 4.f;
+    }
+    auto const avx2 = cpu_has_avx2();
+    if (!avx2) printf("no AVX2 on this CPU, skipping those rows\n");
+
+    auto* const a = angles.data();
+    auto* const p = positive.data();
+    auto* const e = exponents.data();
+    auto* const y = ys.data();
+    auto* const out = results.data();
+
+    run("sin", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = std::sin(a[i]); });
+    run("sin", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = xc::sin(a[i]); });
+    run("sin", "sse2", [&] { batch::map_sse2<simd::sin>(a, out, COUNT); });
+    if (avx2) run("sin", "avx2", [&] { batch::map_avx2<simd::sin>(a, out, COUNT); });
+
+    run("sincos", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) { out[i] = std::sin(a[i]); other[i] = std::cos(a[i]); } });
+    run("sincos", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) xc::sincos(a[i], out[i], other[i]); });
+    run("sincos", "sse2", [&] { batch::sincos_sse2(a, out, other.data(), COUNT); });
+    if (avx2) run("sincos", "avx2", [&] { batch::sincos_avx2(a, out, other.data(), COUNT); });
+
+    run("atan2", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = std::atan2(y[i], a[i]); });
+    run("atan2", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = xc::atan2(y[i], a[i]); });
+    run("atan2", "sse2", [&] { batch::map_sse2<simd::atan2>(y, a, out, COUNT); });
+    if (avx2) run("atan2", "avx2", [&] { batch::map_avx2<simd::atan2>(y, a, out, COUNT); });
+
+    run("exp", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = std::exp(e[i]); });
+    run("exp", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = xc::exp(e[i]); });
+    run("exp", "sse2", [&] { batch::map_sse2<simd::exp>(e, out, COUNT); });
+    if (avx2) run("exp", "avx2", [&] { batch::map_avx2<simd::exp>(e, out, COUNT); });
+
+    run("log", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = std::log(p[i]); });
+    run("log", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = xc::log(p[i]); });
+    run("log", "sse2", [&] { batch::map_sse2<simd::log>(p, out, COUNT); });
+    if (avx2) run("log", "avx2", [&] { batch::map_avx2<simd::log>(p, out, COUNT); });
+
+    run("pow", "libm", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = std::pow(p[i], y[i]); });
+    run("pow", "scalar", [&] { for (auto i = size_t{}; i < COUNT; ++i) out[i] = xc::pow(p[i], y[i]); });
+    run("pow", "sse2", [&] { batch::map_sse2<simd::pow>(p, y, out, COUNT); });
+    if (avx2) run("pow", "avx2", [&] { batch::map_avx2<simd::pow>(p, y, out, COUNT); });
+
+    bench::sink = bench::sink + bit_cast<uint32_t>(results[COUNT / 2u]) + bit_cast<uint32_t>(other[COUNT / 2u]);
+}
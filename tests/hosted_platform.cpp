@@ -0,0 +1,18 @@
+#include <cstdlib>
+
+#include <engine/core/types.h>
+
+// The functions the core headers expect from the platform layer, on top of the C runtime, so tests and benchmarks can
+// run as ordinary programs
+namespace xc {
+    auto allocate(size_t size, memory_tag) -> void* { return malloc(size); }
+    auto deallocate(void* ptr, memory_tag) -> void { free(ptr); }
+    auto reallocate(void* ptr, size_t size, memory_tag) -> void* { return realloc(ptr, size); }
+
+    auto wait_on_address(std::atomic<uint32_t>& word, uint32_t expected) -> void { word.wait(expected, std::memory_order_relaxed); }
+
+    auto wake_on_address(std::atomic<uint32_t>& word, uint32_t count) -> void {
+        if (count == 1u) word.notify_one();
+        else word.notify_all();
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef TESTS_LEGACY_HASH_H
+#define TESTS_LEGACY_HASH_H
+
+#include <engine/core/types.h>
+
+// The table core/hash.h used to be, kept as the baseline for benchmark_hash: linear probing from a 64 bit modulo,
+// with occupancy in a bitset and no tombstones.  Its resize re-probed the new table with the old capacity and bitset;
+// that is fixed here so it survives growing, nothing else is changed
+namespace bench {
+    template<typename Key, typename Value> class legacy_hash {
+    public:
+        legacy_hash() : capacity(16), size(0), threshold(static_cast<size_t>(static_cast<float>(capacity) * 0.75f)),
+                        data(static_cast<entry*>(malloc(capacity * sizeof(entry)))), occupancy(static_cast<uint8_t*>(malloc((capacity + 7) / 8))) {
+            clear();
+        }
+
+        ~legacy_hash() {
+            free(data);
+            free(occupancy);
+        }
+
+        legacy_hash(legacy_hash const&) = delete;
+        auto operator=(legacy_hash const&) -> legacy_hash& = delete;
+
+        auto insert(const Key& key, const Value& value) -> void {
+            if (size >= threshold) resize();
+
+            size_t index = find_index(key);
+            data[index] = {key, value};
+            set_occupancy(occupancy, index);
+            ++size;
+        }
+
+        auto find(const Key& key, Value& value) const -> bool {
+            size_t index = find_index(key);
+            if (is_occupied(occupancy, index) && data[index].key == key) {
+                value = data[index].value;
+                return true;
+            }
+            return false;
+        }
+
+        auto remove(const Key& key) -> bool {
+            size_t index = find_index(key);
+            if (is_occupied(occupancy, index) && data[index].key == key) {
+                clear_occupancy(occupancy, index);
+                --size;
+                return true;
+            }
+            return false;
+        }
+
+        auto clear() -> void {
+            size = 0;
+            memset(occupancy, 0, (capacity + 7) / 8);
+        }
+
+    private:
+        struct entry {
+            Key key;
+            Value value;
+        };
+
+        size_t capacity;
+        size_t size;
+        size_t threshold;
+        entry* data;
+        uint8_t* occupancy;
+
+        auto find_index(const Key& key) const -> size_t {
+            size_t index = wyhash(static_cast<uint64_t>(key)) % capacity;
+            while (is_occupied(occupancy, index) && data[index].key != key) index = (index + 1) % capacity;
+            return index;
+        }
+
+        auto resize() -> void {
+            size_t newCapacity = capacity * 2;
+            entry* newData = static_cast<entry*>(malloc(newCapacity * sizeof(entry)));
+            uint8_t* newOccupancy = static_cast<uint8_t*>(malloc((newCapacity + 7) / 8));
+            memset(newOccupancy, 0, (newCapacity + 7) / 8);
+
+            for (size_t i = 0; i < capacity; ++i) {
+                if (is_occupied(occupancy, i)) {
+                    size_t newIndex = wyhash(static_cast<uint64_t>(data[i].key)) % newCapacity;
+                    while (is_occupied(newOccupancy, newIndex)) newIndex = (newIndex + 1) % newCapacity;
+
+                    newData[newIndex] = data[i];
+                    set_occupancy(newOccupancy, newIndex);
+                }
+            }
+
+            free(data);
+            free(occupancy);
+            data = newData;
+            occupancy = newOccupancy;
+            capacity = newCapacity;
+            threshold = static_cast<size_t>(static_cast<float>(capacity) * 0.75f);
+        }
+
+        auto static is_occupied(uint8_t const* bits, size_t index) -> bool { return (bits[index / 8] >> (index % 8)) & 1; }
+        auto static set_occupancy(uint8_t* bits, size_t index) -> void { bits[index / 8] = static_cast<uint8_t>(bits[index / 8] | (1 << (index % 8))); }
+        auto static clear_occupancy(uint8_t* bits, size_t index) -> void { bits[index / 8] = static_cast<uint8_t>(bits[index / 8] & ~(1 << (index % 8))); }
+    };
+}
+
+#endif // TESTS_LEGACY_HASH_H
@@ -0,0 +1,29 @@
+#ifndef TESTS_TEST_H
+#define TESTS_TEST_H
+
+// Before any engine header: core/types.h defines a move() macro that breaks the standard headers included after it
+#include <cstdint>
+#include <cstdio>
+
+// Checks for the hosted tests.  A failed check prints where it was and the test carries on, so one run reports every
+// failure; main returns test::result() and ctest reads the exit code
+namespace test {
+    inline uint32_t failures = 0u;
+
+    auto inline check(bool condition, char const* expression, char const* file, int line) -> bool {
+        if (!condition) {
+            ++failures;
+            fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        }
+        return condition;
+    }
+
+    auto inline result() -> int {
+        if (failures != 0u) fprintf(stderr, "%u checks failed\n", failures);
+        return failures == 0u ? 0 : 1;
+    }
+}
+
+#define CHECK(...) test::check((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#endif // TESTS_TEST_H
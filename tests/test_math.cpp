@@ -0,0 +1,159 @@
+#include "test.h"
+
+#include <array>
+
+#include <engine/core/math.h>
+
+// The SSE paths in core/math.h against the scalar code they replace.  Constant evaluation always takes the scalar path,
+// so every reference below is computed at compile time from the same inputs the run time calls see
+using namespace xc;
+
+auto static constexpr CASES = 256u;
+
+// xorshift32 mapped to [-4, 4)
+struct generator {
+    uint32_t state = 0x2545f491u;
+
+    constexpr auto next() -> float {
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u) * 8.f - 4.f;
+    }
+
+    constexpr auto next_vector() -> vector4 { return {next(), next(), next(), next()}; }
+    constexpr auto next_matrix() -> matrix4 { return {next_vector(), next_vector(), next_vector(), next_vector()}; }
+};
+
+struct inputs {
+    std::array<vector4, CASES> a, b;
+    std::array<matrix4, CASES> m, n;
+    std::array<quaternion, CASES> q;
+    std::array<float, CASES> s;
+};
+
+auto static constexpr make_inputs() -> inputs {
+    auto r = generator{};
+    auto in = inputs{};
+    for (auto i = 0u; i < CASES; ++i) {
+        in.a[i] = r.next_vector();
+        in.b[i] = r.next_vector();
+        in.m[i] = r.next_matrix();
+        // Diagonally dominant, so the inverse is well conditioned and the two paths can be held to a tight tolerance
+        in.n[i] = r.next_matrix();
+        in.n[i].x.x += 16.f;
+        in.n[i].y.y += 16.f;
+        in.n[i].z.z += 16.f;
+        in.n[i].w.w += 16.f;
+        auto const v = r.next_vector();
+        in.q[i] = normalize(quaternion{v.x, v.y, v.z, v.w});
+        in.s[i] = r.next();
+    }
+    return in;
+}
+
+auto static constexpr IN = make_inputs();
+
+struct results {
+    std::array<vector4, CASES> add, subtract, multiply, divide, scale, minimum, maximum, normalized, transformed;
+    std::array<float, CASES> dot, length;
+    std::array<vector3, CASES> cross, rotated;
+    std::array<matrix4, CASES> product, transposed, inverted, rotation;
+    std::array<float, CASES> determinant;
+    std::array<quaternion, CASES> quaternion_product, blended;
+};
+
+// Takes the scalar paths when called from a constant expression and the SIMD ones otherwise
+auto static constexpr evaluate() -> results {
+    auto r = results{};
+    for (auto i = 0u; i < CASES; ++i) {
+        auto const& a = IN.a[i];
+        auto const& b = IN.b[i];
+        auto const s = IN.s[i];
+        r.add[i] = a + b;
+        r.subtract[i] = a - b;
+        r.multiply[i] = a * b;
+        r.divide[i] = a / (b * b + vector4{1.f, 1.f, 1.f, 1.f});
+        r.scale[i] = a * s;
+        r.minimum[i] = min(a, b);
+        r.maximum[i] = max(a, b);
+        r.normalized[i] = normalize(a);
+        r.transformed[i] = IN.m[i] * a;
+        r.dot[i] = dot(a, b);
+        r.length[i] = length(a);
+        r.cross[i] = cross(vector3{a.x, a.y, a.z}, vector3{b.x, b.y, b.z});
+        r.rotated[i] = rotate(IN.q[i], vector3{a.x, a.y, a.z});
+        r.product[i] = IN.m[i] * IN.n[i];
+        r.transposed[i] = transpose(IN.m[i]);
+        r.inverted[i] = inverse(IN.n[i]);
+        r.rotation[i] = rotation(IN.q[i]);
+        r.determinant[i] = determinant(IN.n[i]);
+        r.quaternion_product[i] = IN.q[i] * IN.q[(i + 1u) % CASES];
+        r.blended[i] = nlerp(IN.q[i], IN.q[(i + 1u) % CASES], 0.25f);
+    }
+    return r;
+}
+
+auto static constexpr REFERENCE = evaluate();
+
+// Relative to the magnitude of the reference, with an absolute floor for results near zero
+auto static close(float actual, float expected, float tolerance) -> bool {
+    return abs(actual - expected) <= tolerance * max(1.f, abs(expected));
+}
+
+auto static close(vector3 const& actual, vector3 const& expected, float tolerance) -> bool {
+    return close(actual.x, expected.x, tolerance) && close(actual.y, expected.y, tolerance) && close(actual.z, expected.z, tolerance);
+}
+
+auto static close(vector4 const& actual, vector4 const& expected, float tolerance) -> bool {
+    return close(actual.x, expected.x, tolerance) && close(actual.y, expected.y, tolerance) &&
+           close(actual.z, expected.z, tolerance) && close(actual.w, expected.w, tolerance);
+}
+
+auto static close(quaternion const& actual, quaternion const& expected, float tolerance) -> bool {
+    return close(vector4{actual.x, actual.y, actual.z, actual.w}, vector4{expected.x, expected.y, expected.z, expected.w}, tolerance);
+}
+
+auto static close(matrix4 const& actual, matrix4 const& expected, float tolerance) -> bool {
+    return close(actual.x, expected.x, tolerance) && close(actual.y, expected.y, tolerance) &&
+           close(actual.z, expected.z, tolerance) && close(actual.w, expected.w, tolerance);
+}
+
+// A few float roundings apart: the SSE code sums in a different order
+auto static constexpr EXACT = 0.f;
+auto static constexpr ROUNDING = 1e-5f;
+// normalize uses the refined hardware rsqrt estimate, good to about 22 bits
+auto static constexpr ESTIMATE = 4e-6f;
+
+auto main() -> int {
+    // Not a constant expression, so this call takes the SIMD paths
+    auto const actual = evaluate();
+
+    for (auto i = 0u; i < CASES; ++i) {
+        CHECK(close(actual.add[i], REFERENCE.add[i], EXACT));
+        CHECK(close(actual.subtract[i], REFERENCE.subtract[i], EXACT));
+        CHECK(close(actual.multiply[i], REFERENCE.multiply[i], EXACT));
+        CHECK(close(actual.divide[i], REFERENCE.divide[i], EXACT));
+        CHECK(close(actual.scale[i], REFERENCE.scale[i], EXACT));
+        CHECK(close(actual.minimum[i], REFERENCE.minimum[i], EXACT));
+        CHECK(close(actual.maximum[i], REFERENCE.maximum[i], EXACT));
+        CHECK(close(actual.normalized[i], REFERENCE.normalized[i], ESTIMATE));
+        CHECK(close(actual.transformed[i], REFERENCE.transformed[i], ROUNDING));
+        CHECK(close(actual.dot[i], REFERENCE.dot[i], ROUNDING));
+        CHECK(close(actual.length[i], REFERENCE.length[i], ROUNDING));
+        CHECK(close(actual.cross[i], REFERENCE.cross[i], ROUNDING));
+        CHECK(close(actual.rotated[i], REFERENCE.rotated[i], ROUNDING));
+        CHECK(close(actual.product[i], REFERENCE.product[i], ROUNDING));
+        CHECK(close(actual.transposed[i], REFERENCE.transposed[i], EXACT));
+        CHECK(close(actual.inverted[i], REFERENCE.inverted[i], ROUNDING));
+        CHECK(close(actual.rotation[i], REFERENCE.rotation[i], ROUNDING));
+        CHECK(close(actual.determinant[i], REFERENCE.determinant[i], ROUNDING));
+        CHECK(close(actual.quaternion_product[i], REFERENCE.quaternion_product[i], ROUNDING));
+        CHECK(close(actual.blended[i], REFERENCE.blended[i], ROUNDING));
+    }
+
+    // The inverse has to undo the matrix, not just agree with the scalar one
+    for (auto i = 0u; i < CASES; ++i) CHECK(close(IN.n[i] * actual.inverted[i], identity<matrix4>(), ROUNDING));
+
+    return test::result();
+}
@@ -0,0 +1,219 @@
+#include "test.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <engine/core/batch.h>
+
+// Accuracy of the core/math.h transcendentals against the double precision C library, checked against the bounds
+// documented on each function.  The 4 and 8 lane kernels are checked to give bit identical results to the scalar form,
+// which is what lets one error measurement stand for all three.  The 8 lane forms are skipped without AVX2
+using namespace xc;
+
+struct outputs {
+    std::vector<float> scalar, lanes4, lanes8;
+};
+
+template<__m128 (*Kernel4)(__m128), __m256 (*Kernel8)(__m256)>
+auto static evaluate(float (*scalar)(float), std::vector<float> const& in) -> outputs {
+    auto out = outputs{std::vector<float>(in.size()), std::vector<float>(in.size()), {}};
+    for (auto i = size_t{}; i < in.size(); ++i) out.scalar[i] = scalar(in[i]);
+    CHECK(batch::map_sse2<Kernel4>(in.data(), out.lanes4.data(), in.size()) == in.size());
+    if (cpu_has_avx2()) {
+        out.lanes8.resize(in.size());
+        CHECK(batch::map_avx2<Kernel8>(in.data(), out.lanes8.data(), in.size()) == in.size());
+    }
+    return out;
+}
+
+template<__m128 (*Kernel4)(__m128, __m128), __m256 (*Kernel8)(__m256, __m256)>
+auto static evaluate(float (*scalar)(float, float), std::vector<float> const& a, std::vector<float> const& b) -> outputs {
+    auto out = outputs{std::vector<float>(a.size()), std::vector<float>(a.size()), {}};
+    for (auto i = size_t{}; i < a.size(); ++i) out.scalar[i] = scalar(a[i], b[i]);
+    CHECK(batch::map_sse2<Kernel4>(a.data(), b.data(), out.lanes4.data(), a.size()) == a.size());
+    if (cpu_has_avx2()) {
+        out.lanes8.resize(a.size());
+        CHECK(batch::map_avx2<Kernel8>(a.data(), b.data(), out.lanes8.data(), a.size()) == a.size());
+    }
+    return out;
+}
+
+// Every width has to produce the same bits, NaNs included
+auto static check_identical(char const* name, outputs const& out) -> void {
+    auto mismatches = 0u;
+    for (auto i = size_t{}; i < out.scalar.size(); ++i) {
+        auto const bits = bit_cast<uint32_t>(out.scalar[i]);
+        if (bits != bit_cast<uint32_t>(out.lanes4[i])) ++mismatches;
+        if (!out.lanes8.empty() && bits != bit_cast<uint32_t>(out.lanes8[i])) ++mismatches;
+    }
+    if (mismatches != 0u) fprintf(stderr, "%s: %u lane results differ from the scalar form\n", name, mismatches);
+    CHECK(mismatches == 0u);
+}
+
+// Units in the last place of the correctly rounded result, so a float that rounds correctly is at most 0.5 away
+auto static ulp_error(float actual, double expected) -> double {
+    auto const rounded = static_cast<float>(expected);
+    auto const exponent = rounded == 0.f ? -126 : std::max(std::ilogb(rounded), -126);
+    return std::fabs(static_cast<double>(actual) - expected) / std::ldexp(1.0, exponent - 23);
+}
+
+struct worst {
+    double error = 0.0;
+    float a = 0.f, b = 0.f;
+
+    auto update(double e, float x, float y = 0.f) -> void {
+        if (e > error) *this = {e, x, y};
+    }
+};
+
+auto static report(char const* name, char const* unit, worst const& w, double bound) -> void {
+    printf("%-8s max %10.3g %-4s at (%.9g, %.9g), documented %g\n", name, w.error, unit, static_cast<double>(w.a), static_cast<double>(w.b), bound);
+}
+
+struct generator {
+    uint32_t state = 0x2545f491u;
+
+    auto next() -> uint32_t {
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return state;
+    }
+
+    auto uniform(float low, float high) -> float {
+        return low + (high - low) * static_cast<float>(next() >> 8u) / static_cast<float>(1u << 24u);
+    }
+
+    // Uniform over the exponents in [low, high], so every magnitude gets the same share of the samples
+    auto logarithmic(int low, int high) -> float {
+        auto const magnitude = std::ldexp(uniform(1.f, 2.f), low + static_cast<int>(next() % static_cast<uint32_t>(high - low + 1)));
+        return next() & 1u ? -magnitude : magnitude;
+    }
+};
+
+auto static constexpr SAMPLES = size_t{1} << 20u;
+
+auto static test_sincos(generator& random) -> void {
+    auto in = std::vector<float>(SAMPLES);
+    for (auto i = size_t{}; i < SAMPLES / 2u; ++i) in[i] = -8192.f + 16384.f * static_cast<float>(i) / static_cast<float>(SAMPLES / 2u);
+    for (auto i = SAMPLES / 2u; i < SAMPLES; ++i) in[i] = random.logarithmic(-24, 12);
+    for (auto& x : in) x = std::clamp(x, -8192.f, 8192.f);
+
+    auto const s = evaluate<simd::sin, simd::sin>(xc::sin, in);
+    auto const c = evaluate<simd::cos, simd::cos>(xc::cos, in);
+    check_identical("sin", s);
+    check_identical("cos", c);
+
+    auto sin_error = worst{}, cos_error = worst{};
+    for (auto i = size_t{}; i < SAMPLES; ++i) {
+        auto const x = static_cast<double>(in[i]);
+        sin_error.update(std::fabs(static_cast<double>(s.scalar[i]) - std::sin(x)), in[i]);
+        cos_error.update(std::fabs(static_cast<double>(c.scalar[i]) - std::cos(x)), in[i]);
+    }
+    report("sin", "abs", sin_error, 1e-7);
+    report("cos", "abs", cos_error, 1e-7);
+    CHECK(sin_error.error < 1e-7);
+    CHECK(cos_error.error < 1e-7);
+}
+
+auto static test_atan2(generator& random) -> void {
+    auto y = std::vector<float>(SAMPLES), x = std::vector<float>(SAMPLES);
+    for (auto i = size_t{}; i < SAMPLES; ++i) {
+        y[i] = random.logarithmic(-20, 20);
+        x[i] = random.logarithmic(-20, 20);
+    }
+    // The axes and the diagonals, where the octant logic changes branch
+    auto constexpr edges = std::array{0.f, -0.f, 1.f, -1.f, 3.f, -3.f};
+    for (auto i = size_t{}; i < edges.size() * edges.size(); ++i) {
+        y[i] = edges[i / edges.size()];
+        x[i] = edges[i % edges.size()];
+    }
+
+    auto const out = evaluate<simd::atan2, simd::atan2>(xc::atan2, y, x);
+    check_identical("atan2", out);
+
+    auto error = worst{};
+    for (auto i = size_t{}; i < SAMPLES; ++i) {
+        if (y[i] == 0.f && x[i] == 0.f) {
+            // Signed zeros and pi, exactly as the C library gives them
+            CHECK(bit_cast<uint32_t>(out.scalar[i]) == bit_cast<uint32_t>(std::signbit(x[i]) ? std::copysign(PI, y[i]) : y[i]));
+            continue;
+        }
+        error.update(ulp_error(out.scalar[i], std::atan2(static_cast<double>(y[i]), static_cast<double>(x[i]))), y[i], x[i]);
+    }
+    report("atan2", "ulp", error, 3.1);
+    CHECK(error.error <= 3.1);
+}
+
+auto static test_exp(generator& random) -> void {
+    // Results stay normal above ln(FLT_MIN), about -87.34
+    auto in = std::vector<float>(SAMPLES);
+    for (auto& x : in) x = random.uniform(-87.33f, approx::EXP_HIGH);
+    in[0] = approx::EXP_HIGH;
+    in[1] = 0.f;
+
+    auto const out = evaluate<simd::exp, simd::exp>(xc::exp, in);
+    check_identical("exp", out);
+
+    auto error = worst{};
+    for (auto i = size_t{}; i < SAMPLES; ++i) error.update(ulp_error(out.scalar[i], std::exp(static_cast<double>(in[i]))), in[i]);
+    report("exp", "ulp", error, 1.0);
+    CHECK(error.error <= 1.0);
+
+    CHECK(xc::exp(100.f) == INFINITY);
+    CHECK(xc::exp(-200.f) == 0.f);
+    CHECK(std::isnan(xc::exp(NAN)));
+}
+
+auto static test_log() -> void {
+    // A stride through every positive finite float, denormals included
+    auto in = std::vector<float>{};
+    for (auto bits = 1u; bits < 0x7f800000u; bits += 1021u) in.push_back(bit_cast<float>(bits));
+    in.resize(in.size() / 8u * 8u);
+
+    auto const out = evaluate<simd::log, simd::log>(xc::log, in);
+    check_identical("log", out);
+
+    auto error = worst{};
+    for (auto i = size_t{}; i < in.size(); ++i) error.update(ulp_error(out.scalar[i], std::log(static_cast<double>(in[i]))), in[i]);
+    report("log", "ulp", error, 0.83);
+    CHECK(error.error <= 0.83);
+
+    CHECK(xc::log(0.f) == -INFINITY);
+    CHECK(std::isnan(xc::log(-1.f)));
+    CHECK(std::isnan(xc::log(NAN)));
+}
+
+auto static test_pow(generator& random) -> void {
+    auto x = std::vector<float>(SAMPLES), y = std::vector<float>(SAMPLES);
+    for (auto i = size_t{}; i < SAMPLES; ++i) {
+        x[i] = std::fabs(random.logarithmic(-8, 8));
+        y[i] = random.uniform(-8.f, 8.f);
+    }
+
+    auto const out = evaluate<simd::pow, simd::pow>(xc::pow, x, y);
+    check_identical("pow", out);
+
+    // The documented growth, 1 + 2 * |y * log(x)| ulp, as a ratio that has to stay at or below 1
+    auto error = worst{};
+    for (auto i = size_t{}; i < SAMPLES; ++i) {
+        auto const a = static_cast<double>(x[i]), b = static_cast<double>(y[i]);
+        auto const bound = 1.0 + 2.0 * std::fabs(b * std::log(a));
+        error.update(ulp_error(out.scalar[i], std::pow(a, b)) / bound, x[i], y[i]);
+    }
+    report("pow", "of bound", error, 1.0);
+    CHECK(error.error <= 1.0);
+}
+
+auto main() -> int {
+    auto random = generator{};
+    if (!cpu_has_avx2()) printf("no AVX2 on this CPU, checking the scalar and 4 lane forms only\n");
+    test_sincos(random);
+    test_atan2(random);
+    test_exp(random);
+    test_log();
+    test_pow(random);
+    return test::result();
+}